@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * HDR-style log-bucketed histogram: values below 2 * sub_count are exact,
+ * above that every power of two is split into sub_count buckets,
+ * so the relative error stays under 1 / sub_count over the whole uint64_t range.
+ * Fixed size, recording is a couple of shifts and an increment.
+ * */
+class LogHistogram {
+public:
+	static constexpr std::size_t sub_bits {5};
+	static constexpr std::size_t sub_count {std::size_t{1} << sub_bits};
+	static constexpr std::size_t buckets_count {(64 - sub_bits + 1) * sub_count};
+
+	void record(std::uint64_t value) noexcept {
+		++counts[bucket_of(value)];
+		++total;
+		min_value = std::min(min_value, value);
+		max_value = std::max(max_value, value);
+	}
+
+	void reset() noexcept {
+		counts.fill(0u);
+		total = 0u;
+		min_value = std::numeric_limits<std::uint64_t>::max();
+		max_value = 0u;
+	}
+
+	/**
+	 * The highest value equivalent to the percentile bucket, p is in [0, 100].
+	 * */
+	std::uint64_t percentile(double p) const noexcept {
+		if (total == 0u) {
+			return 0u;
+		}
+		auto target = static_cast<std::uint64_t>(p / 100. * static_cast<double>(total) + 0.5);
+		target = std::clamp<std::uint64_t>(target, 1u, total);
+		std::uint64_t seen {0};
+		for (std::size_t i = 0; i != buckets_count; ++i) {
+			seen += counts[i];
+			if (seen >= target) {
+				return std::min(highest_of(i), max_value);
+			}
+		}
+		return max_value;
+	}
+
+	std::uint64_t count() const noexcept {
+		return total;
+	}
+
+	std::uint64_t min() const noexcept {
+		return total == 0u ? 0u : min_value;
+	}
+
+	std::uint64_t max() const noexcept {
+		return max_value;
+	}
+
+private:
+	std::array<std::uint64_t, buckets_count> counts {};
+	std::uint64_t total {0};
+	std::uint64_t min_value {std::numeric_limits<std::uint64_t>::max()};
+	std::uint64_t max_value {0};
+
+	static std::size_t bucket_of(std::uint64_t value) noexcept {
+		if (value < 2 * sub_count) {
+			return static_cast<std::size_t>(value);
+		}
+		std::size_t const shift = static_cast<std::size_t>(std::bit_width(value)) - (sub_bits + 1);
+		return (shift + 1) * sub_count + static_cast<std::size_t>((value >> shift) - sub_count);
+	}
+
+	static std::uint64_t highest_of(std::size_t bucket) noexcept {
+		if (bucket < 2 * sub_count) {
+			return bucket;
+		}
+		std::size_t const shift = bucket / sub_count - 1;
+		std::uint64_t const sub = bucket % sub_count + sub_count;
+		return ((sub + 1) << shift) - 1;
+	}
+};
@@ -0,0 +1,255 @@
+//
+// Per-operation tail latency of push_back / pop_front.
+// Every operation (or every small batch of them) is timed individually
+// and recorded into a log-bucketed histogram, then percentiles are printed.
+//
+// circular_buffer_latency [--cpu=N] [--ops=N] [--warmup=N] [--batch=N] [--capacity=N]
+// --capacity picks one of 64, 4096, 65536, 1048576, all of them by default
+//
+
+#include "templates.h"
+#include "histogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+	#define CB_LATENCY_HAS_TSC 1
+#else
+	#include <ctime>
+#endif
+
+#ifdef __linux__
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace {
+
+	//-------------------------
+	// clock: serialized rdtsc where available, clock_gettime elsewhere
+
+	inline std::uint64_t ticks_begin() noexcept {
+#ifdef CB_LATENCY_HAS_TSC
+		_mm_lfence();
+		return __rdtsc();
+#else
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000u + static_cast<std::uint64_t>(ts.tv_nsec);
+#endif
+	}
+
+	inline std::uint64_t ticks_end() noexcept {
+#ifdef CB_LATENCY_HAS_TSC
+		unsigned aux;
+		auto const ticks = __rdtscp(&aux);
+		_mm_lfence();
+		return ticks;
+#else
+		return ticks_begin();
+#endif
+	}
+
+	double ticks_per_ns() {
+#ifdef CB_LATENCY_HAS_TSC
+		using clock = std::chrono::steady_clock;
+		auto const t0 = clock::now();
+		auto const c0 = ticks_begin();
+		while (clock::now() - t0 < std::chrono::milliseconds(100)) {
+		}
+		auto const c1 = ticks_end();
+		auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+		return static_cast<double>(c1 - c0) / static_cast<double>(ns);
+#else
+		return 1.;
+#endif
+	}
+
+	std::uint64_t timer_overhead() {
+		std::uint64_t best {std::numeric_limits<std::uint64_t>::max()};
+		for (int i = 0; i != 10'000; ++i) {
+			auto const t0 = ticks_begin();
+			auto const t1 = ticks_end();
+			best = std::min(best, t1 - t0);
+		}
+		return best;
+	}
+
+	bool pin_to_cpu(int cpu) {
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+		(void)cpu;
+		return false;
+#endif
+	}
+
+
+	//-------------------------
+	// settings
+
+	struct Settings {
+		int cpu {-1};
+		std::size_t ops {1'000'000};
+		std::size_t warmup {100'000};
+		std::size_t batch {1};
+		std::size_t capacity {0};
+	};
+
+	using capacities = std::index_sequence<64, 4096, 1 << 16, 1 << 20>;
+
+	template <std::size_t... N>
+	bool supported_capacity(std::size_t capacity, std::index_sequence<N...>) {
+		return ((capacity == N) || ...);
+	}
+
+	template <std::size_t... N>
+	void print_capacities(std::index_sequence<N...>) {
+		((std::fprintf(stderr, " %zu", N)), ...);
+		std::fprintf(stderr, "\n");
+	}
+
+	Settings parse(int argc, char** argv) {
+		Settings settings;
+		for (int i = 1; i != argc; ++i) {
+			std::string_view const arg {argv[i]};
+			auto const value = [&](std::string_view key) -> char const* {
+				return arg.starts_with(key) ? argv[i] + key.size() : nullptr;
+			};
+			if (auto v = value("--cpu=")) {
+				settings.cpu = std::atoi(v);
+			}
+			else if (auto v = value("--ops=")) {
+				settings.ops = std::strtoull(v, nullptr, 10);
+			}
+			else if (auto v = value("--warmup=")) {
+				settings.warmup = std::strtoull(v, nullptr, 10);
+			}
+			else if (auto v = value("--batch=")) {
+				settings.batch = std::max<std::size_t>(std::strtoull(v, nullptr, 10), 1u);
+			}
+			else if (auto v = value("--capacity=")) {
+				settings.capacity = std::strtoull(v, nullptr, 10);
+				if (not supported_capacity(settings.capacity, capacities{})) {
+					std::fprintf(stderr, "unsupported capacity %s, supported are:", v);
+					print_capacities(capacities{});
+					std::exit(1);
+				}
+			}
+			else {
+				std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+				std::exit(1);
+			}
+		}
+		return settings;
+	}
+
+
+	//-------------------------
+	// measurement
+
+	struct Result {
+		LogHistogram push_back;
+		LogHistogram pop_front;
+	};
+
+	/**
+	 * The window is kept half full, so neither push nor pop hits the edge cases,
+	 * and one sample is the time of settings.batch operations divided by the batch.
+	 * */
+	template <typename Adapter>
+	void measure(Settings const& settings, std::size_t capacity, Result& result) {
+		using T = typename Adapter::value_type;
+		Adapter container (capacity);
+		for (std::size_t i = 0, half = capacity / 2; i != half; ++i) {
+			container.pop();
+		}
+		auto const values = make_values<T>(1u << 10);
+		std::size_t const batch = std::min(settings.batch, capacity / 2);
+		std::size_t v {0};
+
+		auto const run = [&](std::size_t samples, bool record) {
+			for (std::size_t s = 0; s != samples; ++s) {
+				auto const t0 = ticks_begin();
+				for (std::size_t b = 0; b != batch; ++b) {
+					container.push(values[v++ & 1023u]);
+				}
+				auto const t1 = ticks_end();
+				for (std::size_t b = 0; b != batch; ++b) {
+					container.pop();
+				}
+				auto const t2 = ticks_end();
+				if (record) {
+					result.push_back.record((t1 - t0) / batch);
+					result.pop_front.record((t2 - t1) / batch);
+				}
+			}
+		};
+		run(settings.warmup, false);
+		run(settings.ops, true);
+	}
+
+	void print_header(double tpns, std::uint64_t overhead) {
+		std::printf("timer overhead %.1f ns, included in every sample\n", static_cast<double>(overhead) / tpns);
+		std::printf("%-10s %-10s %9s %10s %10s %10s %10s %10s %10s %12s\n",
+					"container", "op", "capacity", "min", "p50", "p90", "p99", "p99.9", "p99.99", "max (ns)");
+	}
+
+	void print_row(char const* container, char const* op, std::size_t capacity, LogHistogram const& h, double tpns) {
+		auto const ns = [&](std::uint64_t ticks) {
+			return static_cast<double>(ticks) / tpns;
+		};
+		std::printf("%-10s %-10s %9zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %12.1f\n",
+					container, op, capacity,
+					ns(h.min()), ns(h.percentile(50.)), ns(h.percentile(90.)), ns(h.percentile(99.)),
+					ns(h.percentile(99.9)), ns(h.percentile(99.99)), ns(h.max()));
+	}
+
+	template <typename Adapter>
+	void run_one(Settings const& settings, std::size_t capacity, double tpns) {
+		//histograms are 15KB each, keep them off the stack
+		auto result = std::make_unique<Result>();
+		measure<Adapter>(settings, capacity, *result);
+		print_row(Adapter::name, "push_back", capacity, result->push_back, tpns);
+		print_row(Adapter::name, "pop_front", capacity, result->pop_front, tpns);
+	}
+
+	template <std::size_t... N>
+	void run_all(Settings const& settings, double tpns, std::index_sequence<N...>) {
+		auto const for_capacity = [&]<std::size_t Capacity>() {
+			if (settings.capacity != 0u && settings.capacity != Capacity) {
+				return;
+			}
+			run_one<adapters::CBFixed<double, Capacity>>(settings, Capacity, tpns);
+			run_one<adapters::Deque<double>>(settings, Capacity, tpns);
+			run_one<adapters::BoostCB<double>>(settings, Capacity, tpns);
+			run_one<adapters::Vector<double>>(settings, Capacity, tpns);
+		};
+		(for_capacity.template operator()<N>(), ...);
+	}
+
+}//!namespace
+
+int main(int argc, char** argv) {
+	Settings const settings = parse(argc, argv);
+	if (settings.cpu >= 0 && not pin_to_cpu(settings.cpu)) {
+		std::fprintf(stderr, "can't pin to cpu %d, running unpinned\n", settings.cpu);
+	}
+	double const tpns = ticks_per_ns();
+	print_header(tpns, timer_overhead());
+	run_all(settings, tpns, capacities{});
+	return 0;
+}
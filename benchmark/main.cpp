@@ -1,240 +1,152 @@
 #include <benchmark/benchmark.h>
 #include "templates.h"
+#include "perf_counters.h"
 
-
-int constexpr range_start {64};
-int constexpr range_stop {cb_capacity * 64};
-
+#include <string>
+#include <utility>
 
 //-------------------------
-// push_back then pop_front
-
-
-static void PushBackPopFrontDeque(benchmark::State& state) {
-	auto v = create<std::deque<data_alias>> (state.range(0));
-	for (auto _ : state){
-		push_back_then_pop_front<std::deque<data_alias>> (v, state.range(0));
-	}
-}
-BENCHMARK(PushBackPopFrontDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void PushBackPopFrontBoostCB(benchmark::State& state) {
-	auto v = create<boost::circular_buffer<data_alias>> (state.range(0));
-	for (auto _ : state){
-		push_back_then_pop_front<boost::circular_buffer<data_alias>> (v, state.range(0));
-	}
-}
-BENCHMARK(PushBackPopFrontBoostCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// the matrix: capacity x element type x operation mix x container
 
-static void PushBackPopFrontCBFixed(benchmark::State& state) {
-	auto v = create<containers::CircularBufferFixed<data_alias, cb_capacity>>(state.range(0));
-	for (auto _ : state){
-		push_back_then_pop_front < CBFixed > (v, state.range(0));
-	}
-}
-BENCHMARK(PushBackPopFrontCBFixed)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+using capacities = std::index_sequence<8, 64, 512, 4096, 1 << 15, 1 << 18, 1 << 20>;
 
-//-------------------------
+static constexpr std::size_t values_count {1 << 10};
+static constexpr std::size_t indices_count {1 << 12};
 
 
-#if 0
 //-------------------------
-// create containter
-
-static void CreateVector(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<std::vector<T>> (state.range(0));
-		benchmark::DoNotOptimize(v);
-	}
-}
-BENCHMARK(CreateVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void CreateDeque(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<std::deque<T>> (state.range(0));
-		benchmark::DoNotOptimize(v);
-	}
-}
-BENCHMARK(CreateDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// push into a full window, the oldest element is overwritten
 
-static void CreateCB(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<boost::circular_buffer<T>> (state.range(0));
-		benchmark::DoNotOptimize(v);
+template <typename Adapter>
+void PushOverwrite(benchmark::State& state, std::size_t capacity) {
+	using T = typename Adapter::value_type;
+	Adapter container (capacity);
+	auto const values = make_values<T>(values_count);
+	std::size_t i {0};
+	perf_counters().start();
+	for (auto _ : state) {
+		container.push(values[i++ & (values_count - 1)]);
 	}
+	perf_counters().stop(state, state.iterations());
+	benchmark::DoNotOptimize(container[0]);
+	state.SetItemsProcessed(state.iterations());
 }
-BENCHMARK(CreateCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
-
 
 
 //-------------------------
-// copy containter
-
-static void CopyVector(benchmark::State& state) {
-	auto v = create<std::vector<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = copy<std::vector<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(CopyVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// push_back then pop_front, the window stays half full
 
-static void CopyDeque(benchmark::State& state) {
-	auto v = create<std::deque<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = copy<std::deque<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
+template <typename Adapter>
+void PushPop(benchmark::State& state, std::size_t capacity) {
+	using T = typename Adapter::value_type;
+	Adapter container (capacity);
+	for (std::size_t i = 0, half = capacity / 2; i != half; ++i) {
+		container.pop();
 	}
-}
-BENCHMARK(CopyDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void CopyCB(benchmark::State& state) {
-	auto v = create<boost::circular_buffer<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = copy<boost::circular_buffer<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
+	auto const values = make_values<T>(values_count);
+	std::size_t i {0};
+	perf_counters().start();
+	for (auto _ : state) {
+		container.push(values[i++ & (values_count - 1)]);
+		container.pop();
 	}
+	perf_counters().stop(state, state.iterations());
+	benchmark::DoNotOptimize(container[0]);
+	state.SetItemsProcessed(state.iterations());
 }
-BENCHMARK(CopyCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
-
 
 
 //-------------------------
-// access element using .at()
-
-static void AtVector(benchmark::State& state) {
-	auto v = create<std::vector<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_at<std::vector<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(AtVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// random reads over a full window
 
-static void AtDeque(benchmark::State& state) {
-	auto v = create<std::deque<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_at<std::deque<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
+template <typename Adapter>
+void RandomAccess(benchmark::State& state, std::size_t capacity) {
+	Adapter container (capacity);
+	auto const indices = make_indices(indices_count, capacity);
+	std::size_t i {0};
+	perf_counters().start();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(container[indices[i++ & (indices_count - 1)]]);
 	}
+	perf_counters().stop(state, state.iterations());
+	state.SetItemsProcessed(state.iterations());
 }
-BENCHMARK(AtDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void AtCB(benchmark::State& state) {
-	auto v = create<boost::circular_buffer<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_at<boost::circular_buffer<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(AtCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
-
 
 
 //-------------------------
-// access element using []
-
-static void BracketsVector(benchmark::State& state) {
-	auto v = create<std::vector<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_square_brackets<std::vector<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(BracketsVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void BracketsDeque(benchmark::State& state) {
-	auto v = create<std::deque<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_square_brackets<std::deque<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(BracketsDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// one pass over a full window, oldest to newest
 
-static void BracketsCB(benchmark::State& state) {
-	auto v = create<boost::circular_buffer<T>> (state.range(0));
-	for (auto _ : state){
-		auto v_copy = address_square_brackets<boost::circular_buffer<T>> (v, state.range(0));
-		benchmark::DoNotOptimize(v_copy);
+template <typename Adapter>
+void Iterate(benchmark::State& state, std::size_t capacity) {
+	Adapter container (capacity);
+	perf_counters().start();
+	for (auto _ : state) {
+		container.for_each([](auto const& elem) {
+			benchmark::DoNotOptimize(elem);
+		});
 	}
+	perf_counters().stop(state, state.iterations() * capacity);
+	state.SetItemsProcessed(state.iterations() * capacity);
 }
-BENCHMARK(BracketsCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
 
 
 //-------------------------
-// add element to the end
-
-static void PushBackOnEmptyVector(benchmark::State& state) {
-	for (auto _ : state){
-		auto v_copy = push_back_on_empty<std::vector<T>> (state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(PushBackOnEmptyVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-
-static void PushBackOnEmptyDeque(benchmark::State& state) {
-	for (auto _ : state){
-		auto v_copy = push_back_on_empty<std::deque<T>> (state.range(0));
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(PushBackOnEmptyDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+// copy a full window
 
-static void PushBackOnEmptyCB(benchmark::State& state) {
-	for (auto _ : state){
-		auto v_copy = push_back_on_empty<boost::circular_buffer<T>> (state.range(0));
-		benchmark::DoNotOptimize(v_copy);
+template <typename Adapter>
+void BulkCopy(benchmark::State& state, std::size_t capacity) {
+	Adapter container (capacity);
+	perf_counters().start();
+	for (auto _ : state) {
+		Adapter copy (container);
+		benchmark::DoNotOptimize(copy[0]);
 	}
+	perf_counters().stop(state, state.iterations() * capacity);
+	state.SetItemsProcessed(state.iterations() * capacity);
 }
-BENCHMARK(PushBackOnEmptyCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
 
 
 //-------------------------
-// pop first elemennt
+// registration
 
-static void PopFrontVector(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<std::vector<T>> (state.range(0));
-		auto v_copy = pop_front<std::vector<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
-	}
-}
-BENCHMARK(PopFrontVector)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
+template <typename Adapter>
+void register_ops(std::size_t capacity) {
+	using T = typename Adapter::value_type;
+	auto const suffix = std::string("/") + Adapter::name + "/" + type_name<T>() + "/" + std::to_string(capacity);
 
-static void PopFrontDeque(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<std::deque<T>> (state.range(0));
-		auto v_copy = pop_front<std::deque<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
-	}
+	auto const add = [&](char const* op, void (*fn)(benchmark::State&, std::size_t)) {
+		benchmark::RegisterBenchmark((op + suffix).c_str(), [fn, capacity](benchmark::State& state) {
+			fn(state, capacity);
+		})->Unit(benchmark::kNanosecond);
+	};
+	add("PushOverwrite", &PushOverwrite<Adapter>);
+	add("PushPop", &PushPop<Adapter>);
+	add("RandomAccess", &RandomAccess<Adapter>);
+	add("Iterate", &Iterate<Adapter>);
+	add("BulkCopy", &BulkCopy<Adapter>);
 }
-BENCHMARK(PopFrontDeque)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
 
-static void PopFrontCB(benchmark::State& state) {
-	for (auto _ : state){
-		auto v = create<boost::circular_buffer<T>> (state.range(0));
-		auto v_copy = pop_front<boost::circular_buffer<T>> (v);
-		benchmark::DoNotOptimize(v_copy);
-	}
+template <typename T, std::size_t... N>
+void register_type(std::index_sequence<N...>) {
+	(register_ops<adapters::CBFixed<T, N>>(N), ...);
+	(register_ops<adapters::Deque<T>>(N), ...);
+	(register_ops<adapters::BoostCB<T>>(N), ...);
+	(register_ops<adapters::Vector<T>>(N), ...);
 }
-BENCHMARK(PopFrontCB)->Range(range_start, range_stop)->Unit(benchmark::kNanosecond);
-//-------------------------
-
-#endif
 
+int main(int argc, char** argv) {
+	//opened once up front, counters are reported per operation next to the timings
+	perf_counters();
 
+	register_type<double>(capacities{});
+	register_type<Pod64>(capacities{});
+	register_type<std::string>(capacities{});
 
-
-
-BENCHMARK_MAIN();
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
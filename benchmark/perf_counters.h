@@ -0,0 +1,144 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+/**
+ * Hardware counters of the calling thread via perf_event_open.
+ * Every event is opened on its own rather than as a group: six events
+ * don't fit the PMU at once on most cores, so the kernel multiplexes them
+ * and values are scaled by time_enabled / time_running.
+ * Events that can't be opened (no PMU, VM, perf_event_paranoid) are skipped
+ * and left out of the report. If none is available, the constructor prints
+ * the reason to stderr and no counters are reported.
+ * */
+class PerfCounters {
+public:
+	struct Event {
+		char const* name;
+		std::uint32_t type;
+		std::uint64_t config;
+	};
+
+	static constexpr std::size_t events_count {6};
+
+	PerfCounters() {
+#ifdef __linux__
+		auto const cache = [](std::uint64_t cache_id) -> std::uint64_t {
+			return cache_id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		};
+		events = {{
+				{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+				{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+				{"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+				{"L1d-misses", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D)},
+				{"LLC-misses", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL)},
+				{"dTLB-misses", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB)},
+		}};
+		int first_errno {0};
+		for (std::size_t i = 0; i != events_count; ++i) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = events[i].type;
+			attr.config = events[i].config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+			if (fds[i] < 0 && first_errno == 0) {
+				first_errno = errno;
+			}
+		}
+		if (not available()) {
+			bool const denied = first_errno == EACCES || first_errno == EPERM;
+			std::fprintf(stderr, "perf counters are not available: %s%s\n", std::strerror(first_errno),
+						 denied ? ", check /proc/sys/kernel/perf_event_paranoid" : "");
+		}
+#endif
+	}
+
+	~PerfCounters() {
+#ifdef __linux__
+		for (int fd : fds) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+#endif
+	}
+
+	PerfCounters(PerfCounters const&) = delete;
+	PerfCounters& operator=(PerfCounters const&) = delete;
+
+	bool available() const noexcept {
+		for (int fd : fds) {
+			if (fd >= 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void start() noexcept {
+#ifdef __linux__
+		for (int fd : fds) {
+			if (fd >= 0) {
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	/**
+	 * Stops counting and reports every available counter
+	 * divided by the number of operations done in the run.
+	 * */
+	void stop(benchmark::State& state, std::uint64_t ops) noexcept {
+#ifdef __linux__
+		for (int fd : fds) {
+			if (fd >= 0) {
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+		if (ops == 0u) {
+			return;
+		}
+		for (std::size_t i = 0; i != events_count; ++i) {
+			std::uint64_t values[3] {};
+			if (fds[i] < 0 || read(fds[i], values, sizeof(values)) != sizeof(values) || values[2] == 0u) {
+				continue;
+			}
+			double const scaled = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+			state.counters[events[i].name] = scaled / static_cast<double>(ops);
+		}
+#else
+		(void)state;
+		(void)ops;
+#endif
+	}
+
+private:
+	std::array<Event, events_count> events {};
+	std::array<int, events_count> fds {-1, -1, -1, -1, -1, -1};
+};
+
+inline PerfCounters& perf_counters() {
+	static PerfCounters counters;
+	return counters;
+}
@@ -11,109 +11,277 @@
 #include "boost/circular_buffer.hpp"
 #include "../include/circular_buffer_fixed.hpp"
 
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <cassert>
 
-using data_alias = double;
+//-------------------------
+// element types
 
-static constexpr data_alias lower_bound = -1.e5;
-static constexpr data_alias upper_bound = 1.e5;
-static constexpr data_alias  double_value {42.5};
+struct Pod64 {
+	std::array<double, 8> payload;
+};
+static_assert(sizeof(Pod64) == 64u);
 
-static constexpr int cb_capacity {1 << 5};
-using CBFixed = containers::CircularBufferFixed<data_alias, cb_capacity>;
-
-template<typename Container>
-requires (requires {!std::same_as<Container, CBFixed>;})
-Container create (std::size_t size) {
-	Container container;
-	container.resize(size);
-	return container;
-}
-
-template<>
-CBFixed create (std::size_t) {
-	CBFixed container(data_alias{});
-	return container;
-}
-
-template<typename  Container>
-Container copy (const Container &container) {
-	return Container{begin(container), end(container)};
+template <typename T>
+T make_value (std::size_t i) {
+	if constexpr (std::is_same_v<T, Pod64>) {
+		Pod64 value;
+		value.payload.fill(static_cast<double>(i));
+		return value;
+	}
+	else if constexpr (std::is_same_v<T, std::string>) {
+		//long enough to stay out of SSO
+		return std::string(32u, static_cast<char>('a' + i % 26u));
+	}
+	else {
+		return static_cast<T>(i);
+	}
 }
 
-template<typename  Container>
-Container address_at (Container const &container, std::size_t size) {
-	Container results {create<Container>(size)};
-	int j {0};
-	for (std::size_t i = 0; i != size; ++i) {
-		j = prm(0, size - 1);
-		results.at(i) = container.at(j);
+template <typename T>
+constexpr char const* type_name () {
+	if constexpr (std::is_same_v<T, Pod64>) {
+		return "pod64";
+	}
+	else if constexpr (std::is_same_v<T, std::string>) {
+		return "string";
+	}
+	else {
+		return "double";
 	}
-	return results;
 }
 
-template<typename  Container>
-Container address_square_brackets (Container const &container, std::size_t size) {
-	Container results {create<Container>(size)};
-	int j {0};
-	for (std::size_t i = 0; i != size; ++i) {
-		j = prm(0, size - 1);
-		results[i] = container[j];
+template <typename T>
+std::vector<T> make_values (std::size_t count) {
+	std::vector<T> values;
+	values.reserve(count);
+	for (std::size_t i = 0; i != count; ++i) {
+		values.push_back(make_value<T>(i));
 	}
-	return results;
+	return values;
 }
 
-template<typename  Container>
-Container push_back_on_empty (std::size_t new_elem_count) {
-	Container container;
-	for (std::size_t i = 0, j = new_elem_count; i != j; ++i) {
-		container.push_back(double_value);
+inline std::vector<std::size_t> make_indices (std::size_t count, std::size_t upper_bound) {
+	std::vector<std::size_t> indices (count);
+	for (auto& idx : indices) {
+		idx = static_cast<std::size_t>(prm(0, static_cast<int>(upper_bound - 1)));
 	}
-	return container;
+	return indices;
 }
 
 
-template<typename  Container>
-int pop_front (Container &container) {
-	int count = 0;
-	assert(container.size() > 0);
-	if constexpr (not std::is_same_v<Container, std::vector<typename Container::value_type>>){
-		while (not container.empty()) {
-			container.pop_front();
-			++count;
+//-------------------------
+// adapters: the same window semantics on top of every container
+// - ctor makes a full window of the requested capacity
+// - push() appends, dropping the oldest element when full
+// - pop() removes the oldest element, container is not empty
+
+namespace adapters {
+
+	template <typename T, std::size_t N>
+	class CBFixed {
+	public:
+		using value_type = T;
+		using container_type = containers::CircularBufferFixed<T, N>;
+		static constexpr char const* name {"CBFixed"};
+
+		explicit CBFixed (std::size_t capacity)
+				//1M of Pod64 doesn't fit a stack
+				: cb {std::make_unique<container_type>()}
+		{
+			assert(capacity == N);
+			for (std::size_t i = 0; i != capacity; ++i) {
+				cb->push_back(make_value<T>(i));
+			}
 		}
-	}
-	else{
-		while (not container.empty()) {
-			container.erase(container.begin());
-			++count;
+
+		CBFixed (CBFixed const& other)
+				: cb {std::make_unique<container_type>(*other.cb)}
+		{}
+
+		void push(T const& value) {
+			cb->push_back(value);
 		}
-	}
-	return count;
-}
 
+		void pop() {
+			cb->pop_front();
+		}
 
-template<typename  Container>
-int push_back_then_pop_front (Container &container, std::size_t iterations) {
-	assert(container.size() > 0);
-	int count {0};
-	for (std::size_t i = 0; i != iterations; ++i) {
-		if constexpr (std::is_same_v<Container, std::vector<typename Container::value_type>>) {
-			container.push_back(double_value);
-			container.erase(container.begin());
+		T const& operator[](std::size_t idx) const {
+			return (*cb)[idx];
 		}
-		else if constexpr (std::is_same_v<Container, std::deque<typename Container::value_type>>) {
-			container.push_back(double_value);
-			container.pop_front();
+
+		std::size_t size() const {
+			return cb->size();
 		}
-		else if constexpr (std::is_same_v<Container, boost::circular_buffer<typename Container::value_type>>) {
-			container.push_back(double_value);
+
+		template <typename F>
+		void for_each(F f) const {
+			for (std::size_t i = 0, sz = cb->size(); i != sz; ++i) {
+				f((*cb)[i]);
+			}
 		}
-		else if constexpr (std::is_same_v<Container, containers::CircularBufferFixed<typename Container::value_type, Container::capacity()>>) {
-			container.push_back(double_value);
+
+	private:
+		std::unique_ptr<container_type> cb;
+	};
+
+	template <typename T>
+	class Deque {
+	public:
+		using value_type = T;
+		static constexpr char const* name {"Deque"};
+
+		explicit Deque (std::size_t capacity)
+				: cap {capacity}
+		{
+			for (std::size_t i = 0; i != capacity; ++i) {
+				d.push_back(make_value<T>(i));
+			}
 		}
-		count += count / double_value;
-	}
-	return count;
-}
+
+		void push(T const& value) {
+			if (d.size() == cap) {
+				d.pop_front();
+			}
+			d.push_back(value);
+		}
+
+		void pop() {
+			d.pop_front();
+		}
+
+		T const& operator[](std::size_t idx) const {
+			return d[idx];
+		}
+
+		std::size_t size() const {
+			return d.size();
+		}
+
+		template <typename F>
+		void for_each(F f) const {
+			for (auto const& elem : d) {
+				f(elem);
+			}
+		}
+
+	private:
+		std::size_t cap;
+		std::deque<T> d;
+	};
+
+	template <typename T>
+	class BoostCB {
+	public:
+		using value_type = T;
+		static constexpr char const* name {"BoostCB"};
+
+		explicit BoostCB (std::size_t capacity)
+				: cb (capacity)
+		{
+			for (std::size_t i = 0; i != capacity; ++i) {
+				cb.push_back(make_value<T>(i));
+			}
+		}
+
+		void push(T const& value) {
+			cb.push_back(value);
+		}
+
+		void pop() {
+			cb.pop_front();
+		}
+
+		T const& operator[](std::size_t idx) const {
+			return cb[idx];
+		}
+
+		std::size_t size() const {
+			return cb.size();
+		}
+
+		template <typename F>
+		void for_each(F f) const {
+			for (auto const& elem : cb) {
+				f(elem);
+			}
+		}
+
+	private:
+		boost::circular_buffer<T> cb;
+	};
+
+	/**
+	 * Baseline: the plainest ring over std::vector, modulo-free wrap.
+	 * */
+	template <typename T>
+	class Vector {
+	public:
+		using value_type = T;
+		static constexpr char const* name {"Vector"};
+
+		explicit Vector (std::size_t capacity)
+				: v    (capacity)
+				, head {0}
+				, sz   {capacity}
+		{
+			for (std::size_t i = 0; i != capacity; ++i) {
+				v[i] = make_value<T>(i);
+			}
+		}
+
+		void push(T const& value) {
+			std::size_t tail = head + sz;
+			if (tail >= v.size()) {
+				tail -= v.size();
+			}
+			v[tail] = value;
+			if (sz == v.size()) {
+				advance_head();
+			}
+			else {
+				++sz;
+			}
+		}
+
+		void pop() {
+			advance_head();
+			--sz;
+		}
+
+		T const& operator[](std::size_t idx) const {
+			idx += head;
+			return v[idx < v.size() ? idx : idx - v.size()];
+		}
+
+		std::size_t size() const {
+			return sz;
+		}
+
+		template <typename F>
+		void for_each(F f) const {
+			for (std::size_t i = head, e = std::min(head + sz, v.size()); i != e; ++i) {
+				f(v[i]);
+			}
+			for (std::size_t i = 0, e = head + sz > v.size() ? head + sz - v.size() : 0u; i != e; ++i) {
+				f(v[i]);
+			}
+		}
+
+	private:
+		std::vector<T> v;
+		std::size_t head, sz;
+
+		void advance_head() {
+			if (++head == v.size()) {
+				head = 0;
+			}
+		}
+	};
+
+}//!namespace adapters
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "circular_buffer_fixed.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <ctime>
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace containers {
+
+	namespace details {
+
+		inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			asm volatile("yield" ::: "memory");
+#endif
+		}
+
+		/**
+		 * std::atomic::wait has no timed form. On Linux a timed waiter goes
+		 * to the same futex directly, elsewhere it polls with yields.
+		 * Returns false if the deadline has passed with the word unchanged.
+		 * */
+		template <typename Clock, typename Duration>
+		bool park_until(std::atomic<std::uint32_t>& word, std::uint32_t seen,
+						std::chrono::time_point<Clock, Duration> deadline) noexcept {
+			static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+			while (word.load(std::memory_order_seq_cst) == seen) {
+				auto const now = Clock::now();
+				if (now >= deadline) {
+					return false;
+				}
+#ifdef __linux__
+				auto const left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+				timespec timeout;
+				timeout.tv_sec = static_cast<time_t>(left.count() / 1'000'000'000);
+				timeout.tv_nsec = static_cast<long>(left.count() % 1'000'000'000);
+				syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, seen, &timeout, nullptr, 0);
+#else
+				std::this_thread::yield();
+#endif
+			}
+			return true;
+		}
+
+		inline void unpark_timed_one([[maybe_unused]] std::atomic<std::uint32_t>& word) noexcept {
+#ifdef __linux__
+			syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+		}
+
+		/**
+		 * One side of the queue: an epoch bumped on every change
+		 * and the number of threads parked on it.
+		 * */
+		struct alignas(64) WaitChannel {
+			std::atomic<std::uint32_t> epoch {0};
+			std::atomic<std::uint32_t> waiters {0};
+			std::atomic<std::uint32_t> timed_waiters {0};
+
+			/**
+			 * seq_cst on both sides: either the waiter sees the new epoch,
+			 * or the notifier sees the waiter, a wake-up can't be lost.
+			 * No syscall at all when nobody is parked.
+			 * */
+			void notify() noexcept {
+				epoch.fetch_add(1u, std::memory_order_seq_cst);
+				if (waiters.load(std::memory_order_seq_cst) != 0u) [[unlikely]] {
+					epoch.notify_one();
+				}
+				if (timed_waiters.load(std::memory_order_seq_cst) != 0u) [[unlikely]] {
+					unpark_timed_one(epoch);
+				}
+			}
+		};
+
+	}//!namespace details
+
+	/**
+	 * Bounded MPMC queue over CircularBufferFixed with blocking push/pop.
+	 * A thread that can't proceed spins for Spins rounds, then parks on
+	 * std::atomic::wait (a futex on Linux) until the other side moves.
+	 * */
+	template <typename T, std::size_t N, std::size_t Spins = 128>
+	class BlockingQueue {
+	public:
+		using value_type = T;
+
+		void push(T t) {
+			wait(not_full, [&] {
+				return try_push_locked(t);
+			});
+			not_empty.notify();
+		}
+
+		bool try_push(T t) {
+			if (not try_push_locked(t)) {
+				return false;
+			}
+			not_empty.notify();
+			return true;
+		}
+
+		template <typename Rep, typename Period>
+		bool try_push_for(T t, std::chrono::duration<Rep, Period> timeout) {
+			return try_push_until(std::move(t), std::chrono::steady_clock::now() + timeout);
+		}
+
+		template <typename Clock, typename Duration>
+		bool try_push_until(T t, std::chrono::time_point<Clock, Duration> deadline) {
+			bool const pushed = wait_until(not_full, deadline, [&] {
+				return try_push_locked(t);
+			});
+			if (pushed) {
+				not_empty.notify();
+			}
+			return pushed;
+		}
+
+		T pop() {
+			std::optional<T> res;
+			wait(not_empty, [&] {
+				return try_pop_locked(res);
+			});
+			not_full.notify();
+			return std::move(*res);
+		}
+
+		std::optional<T> try_pop() {
+			std::optional<T> res;
+			if (try_pop_locked(res)) {
+				not_full.notify();
+			}
+			return res;
+		}
+
+		template <typename Rep, typename Period>
+		std::optional<T> try_pop_for(std::chrono::duration<Rep, Period> timeout) {
+			return try_pop_until(std::chrono::steady_clock::now() + timeout);
+		}
+
+		template <typename Clock, typename Duration>
+		std::optional<T> try_pop_until(std::chrono::time_point<Clock, Duration> deadline) {
+			std::optional<T> res;
+			bool const popped = wait_until(not_empty, deadline, [&] {
+				return try_pop_locked(res);
+			});
+			if (popped) {
+				not_full.notify();
+			}
+			return res;
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+		std::size_t size() const {
+			std::lock_guard lock (m);
+			return ring.size();
+		}
+
+		bool empty() const {
+			std::lock_guard lock (m);
+			return ring.empty();
+		}
+
+	private:
+		mutable std::mutex m;
+		CircularBufferFixed<T, N> ring;
+		details::WaitChannel not_empty;
+		details::WaitChannel not_full;
+
+		bool try_push_locked(T& t) {
+			std::lock_guard lock (m);
+			if (ring.size() == N) {
+				return false;
+			}
+			ring.push_back(std::move(t));
+			return true;
+		}
+
+		bool try_pop_locked(std::optional<T>& res) {
+			std::lock_guard lock (m);
+			if (ring.empty()) {
+				return false;
+			}
+			res.emplace(std::move(ring.pop_front()));
+			return true;
+		}
+
+		/**
+		 * The epoch is read before the attempt: whatever happens
+		 * on the other side after a failed attempt changes it.
+		 * */
+		template <typename Attempt>
+		static bool spin(details::WaitChannel& channel, std::uint32_t& seen, Attempt& attempt) {
+			seen = channel.epoch.load(std::memory_order_seq_cst);
+			if (attempt()) {
+				return true;
+			}
+			for (std::size_t i = 0; i != Spins; ++i) {
+				details::cpu_relax();
+				if (channel.epoch.load(std::memory_order_relaxed) != seen) {
+					seen = channel.epoch.load(std::memory_order_seq_cst);
+					if (attempt()) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		template <typename Attempt>
+		static void wait(details::WaitChannel& channel, Attempt attempt) {
+			std::uint32_t seen;
+			while (not spin(channel, seen, attempt)) {
+				channel.waiters.fetch_add(1u, std::memory_order_seq_cst);
+				channel.epoch.wait(seen, std::memory_order_seq_cst);
+				channel.waiters.fetch_sub(1u, std::memory_order_relaxed);
+			}
+		}
+
+		template <typename Clock, typename Duration, typename Attempt>
+		static bool wait_until(details::WaitChannel& channel, std::chrono::time_point<Clock, Duration> deadline, Attempt attempt) {
+			std::uint32_t seen;
+			while (not spin(channel, seen, attempt)) {
+				channel.timed_waiters.fetch_add(1u, std::memory_order_seq_cst);
+				bool const moved = details::park_until(channel.epoch, seen, deadline);
+				channel.timed_waiters.fetch_sub(1u, std::memory_order_relaxed);
+				if (not moved) {
+					return attempt();
+				}
+			}
+			return true;
+		}
+	};
+
+}//!namespace containers
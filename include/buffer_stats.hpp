@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace containers::stats {
+
+	struct Snapshot {
+		std::uint64_t pushes {0};
+		std::uint64_t pops {0};
+		std::uint64_t overwrites {0};
+		std::uint64_t pops_on_empty {0};
+		std::uint64_t high_water_mark {0};
+	};
+
+	/**
+	 * Statistics policy of a container, called on every modification:
+	 * on_push(overwrote, size after push), on_pop(was empty).
+	 * Null is an empty class with no-op hooks, so it takes no space
+	 * and compiles away entirely.
+	 * */
+	struct Null {
+		constexpr void on_push(bool, std::size_t) noexcept {}
+		constexpr void on_pop(bool) noexcept {}
+	};
+
+	/**
+	 * Plain counters, for a buffer owned by a single thread.
+	 * */
+	class Counting {
+	public:
+		constexpr void on_push(bool overwrote, std::size_t size) noexcept {
+			++counters.pushes;
+			counters.overwrites += overwrote;
+			counters.high_water_mark = std::max<std::uint64_t>(counters.high_water_mark, size);
+		}
+
+		constexpr void on_pop(bool was_empty) noexcept {
+			++counters.pops;
+			counters.pops_on_empty += was_empty;
+		}
+
+		constexpr Snapshot snapshot() const noexcept {
+			return counters;
+		}
+
+		constexpr void reset() noexcept {
+			counters = Snapshot{};
+		}
+
+	private:
+		Snapshot counters;
+	};
+
+	/**
+	 * Relaxed atomic counters, for a snapshot taken from another thread
+	 * while the owner keeps modifying the buffer. Only the owner writes,
+	 * so load + store is enough and there are no locked instructions.
+	 * */
+	class AtomicCounting {
+	public:
+		AtomicCounting () = default;
+
+		AtomicCounting (AtomicCounting const& other) noexcept {
+			assign(other.snapshot());
+		}
+
+		AtomicCounting& operator=(AtomicCounting const& other) noexcept {
+			assign(other.snapshot());
+			return *this;
+		}
+
+		void on_push(bool overwrote, std::size_t size) noexcept {
+			bump(pushes, 1u);
+			bump(overwrites, overwrote);
+			if (size > high_water_mark.load(std::memory_order_relaxed)) {
+				high_water_mark.store(size, std::memory_order_relaxed);
+			}
+		}
+
+		void on_pop(bool was_empty) noexcept {
+			bump(pops, 1u);
+			bump(pops_on_empty, was_empty);
+		}
+
+		Snapshot snapshot() const noexcept {
+			Snapshot s;
+			s.pushes = pushes.load(std::memory_order_relaxed);
+			s.pops = pops.load(std::memory_order_relaxed);
+			s.overwrites = overwrites.load(std::memory_order_relaxed);
+			s.pops_on_empty = pops_on_empty.load(std::memory_order_relaxed);
+			s.high_water_mark = high_water_mark.load(std::memory_order_relaxed);
+			return s;
+		}
+
+		void reset() noexcept {
+			assign(Snapshot{});
+		}
+
+	private:
+		std::atomic<std::uint64_t> pushes {0}, pops {0}, overwrites {0}, pops_on_empty {0}, high_water_mark {0};
+
+		void assign(Snapshot const& s) noexcept {
+			pushes.store(s.pushes, std::memory_order_relaxed);
+			pops.store(s.pops, std::memory_order_relaxed);
+			overwrites.store(s.overwrites, std::memory_order_relaxed);
+			pops_on_empty.store(s.pops_on_empty, std::memory_order_relaxed);
+			high_water_mark.store(s.high_water_mark, std::memory_order_relaxed);
+		}
+
+		static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+	};
+
+}//!namespace containers::stats
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "circular_buffer_fixed.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace containers {
+
+	/**
+	 * Intrusive link of a suspended coroutine in a ready or wait list,
+	 * it lives inside the awaiter, so scheduling never allocates.
+	 * */
+	struct ScheduleNode {
+		ScheduleNode* next {nullptr};
+		std::coroutine_handle<> handle;
+	};
+
+	/**
+	 * Single-threaded FIFO executor: resumes scheduled coroutines
+	 * one after another on the thread that calls run().
+	 * */
+	class LocalExecutor {
+	public:
+		void schedule(ScheduleNode& node) noexcept {
+			node.next = nullptr;
+			if (tail) {
+				tail->next = &node;
+			}
+			else {
+				head = &node;
+			}
+			tail = &node;
+		}
+
+		bool run_one() {
+			if (not head) {
+				return false;
+			}
+			ScheduleNode* node = head;
+			head = node->next;
+			if (not head) {
+				tail = nullptr;
+			}
+			node->handle.resume();
+			return true;
+		}
+
+		/**
+		 * Runs until nothing is ready, returns the number of resumptions.
+		 * */
+		std::size_t run() {
+			std::size_t count {0};
+			while (run_one()) {
+				++count;
+			}
+			return count;
+		}
+
+		template <typename Task>
+		void spawn(Task task) noexcept {
+			auto& node = task.release();
+			schedule(node);
+		}
+
+	private:
+		ScheduleNode* head {nullptr};
+		ScheduleNode* tail {nullptr};
+	};
+
+	/**
+	 * Fire-and-forget coroutine, created suspended and started by LocalExecutor::spawn.
+	 * The frame is destroyed when the coroutine finishes.
+	 * */
+	class Task {
+	public:
+		struct promise_type {
+			ScheduleNode node;
+
+			Task get_return_object() noexcept {
+				return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend() noexcept {
+				return {};
+			}
+			std::suspend_never final_suspend() noexcept {
+				return {};
+			}
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept {
+				std::terminate();
+			}
+		};
+
+		Task (Task&& other) noexcept
+				: h {std::exchange(other.h, nullptr)}
+		{}
+
+		Task& operator=(Task&&) = delete;
+
+		~Task() {
+			if (h) {
+				h.destroy();
+			}
+		}
+
+		ScheduleNode& release() noexcept {
+			auto& node = h.promise().node;
+			node.handle = std::exchange(h, nullptr);
+			return node;
+		}
+
+	private:
+		std::coroutine_handle<promise_type> h;
+
+		explicit Task (std::coroutine_handle<promise_type> h) noexcept
+				: h {h}
+		{}
+	};
+
+	/**
+	 * Bounded channel between coroutines of one LocalExecutor.
+	 * co_await pop() suspends while the ring is empty, co_await push(v) while it is full,
+	 * the other side hands the value over and schedules the waiter.
+	 * Awaiters live in the coroutine frames, there is no allocation per operation.
+	 * Not thread-safe: every coroutine using a channel runs on the same executor.
+	 * */
+	template <typename T, std::size_t N>
+	class Channel {
+	public:
+		class PopAwaiter;
+
+		class PushAwaiter {
+		public:
+			PushAwaiter (Channel& channel, T value)
+					: channel {channel}
+					, value   {std::move(value)}
+			{}
+
+			bool await_ready() {
+				if (PopAwaiter* popper = channel.poppers.pop()) {
+					popper->value.emplace(std::move(value));
+					channel.executor.schedule(popper->node);
+					return true;
+				}
+				if (channel.ring.size() < N) {
+					channel.ring.push_back(std::move(value));
+					return true;
+				}
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> h) noexcept {
+				node.handle = h;
+				channel.pushers.push(this);
+			}
+
+			void await_resume() const noexcept {}
+
+		private:
+			friend class Channel;
+			template <typename Awaiter> friend class WaitList;
+
+			Channel& channel;
+			T value;
+			ScheduleNode node;
+			PushAwaiter* next {nullptr};
+		};
+
+		class PopAwaiter {
+		public:
+			explicit PopAwaiter (Channel& channel)
+					: channel {channel}
+			{}
+
+			bool await_ready() {
+				if (channel.ring.empty()) {
+					return false;
+				}
+				value.emplace(std::move(channel.ring.pop_front()));
+				if (PushAwaiter* pusher = channel.pushers.pop()) {
+					channel.ring.push_back(std::move(pusher->value));
+					channel.executor.schedule(pusher->node);
+				}
+				return true;
+			}
+
+			void await_suspend(std::coroutine_handle<> h) noexcept {
+				node.handle = h;
+				channel.poppers.push(this);
+			}
+
+			T await_resume() {
+				return std::move(*value);
+			}
+
+		private:
+			friend class Channel;
+			template <typename Awaiter> friend class WaitList;
+
+			Channel& channel;
+			std::optional<T> value;
+			ScheduleNode node;
+			PopAwaiter* next {nullptr};
+		};
+
+		explicit Channel (LocalExecutor& executor)
+				: executor {executor}
+		{}
+
+		Channel (Channel const&) = delete;
+		Channel& operator=(Channel const&) = delete;
+
+		[[nodiscard]] PushAwaiter push(T value) {
+			return PushAwaiter(*this, std::move(value));
+		}
+
+		[[nodiscard]] PopAwaiter pop() {
+			return PopAwaiter(*this);
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+		std::size_t size() const noexcept {
+			return ring.size();
+		}
+
+		bool empty() const noexcept {
+			return ring.empty();
+		}
+
+	private:
+		template <typename Awaiter>
+		class WaitList {
+		public:
+			void push(Awaiter* awaiter) noexcept {
+				awaiter->next = nullptr;
+				if (tail) {
+					tail->next = awaiter;
+				}
+				else {
+					head = awaiter;
+				}
+				tail = awaiter;
+			}
+
+			Awaiter* pop() noexcept {
+				Awaiter* awaiter = head;
+				if (awaiter) {
+					head = awaiter->next;
+					if (not head) {
+						tail = nullptr;
+					}
+				}
+				return awaiter;
+			}
+
+		private:
+			Awaiter* head {nullptr};
+			Awaiter* tail {nullptr};
+		};
+
+		LocalExecutor& executor;
+		CircularBufferFixed<T, N> ring;
+		WaitList<PushAwaiter> pushers;
+		WaitList<PopAwaiter> poppers;
+	};
+
+}//!namespace containers
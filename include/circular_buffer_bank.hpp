@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace containers {
+
+	namespace details {
+
+		inline constexpr std::size_t cache_line_size {64};
+
+		/**
+		 * Rows are padded up to a whole number of cache lines,
+		 * so every row starts aligned and is written with aligned stores.
+		 * */
+		template <typename T, std::size_t K>
+		constexpr std::size_t row_stride() noexcept {
+			if constexpr (cache_line_size % sizeof(T) == 0u) {
+				constexpr std::size_t per_line {cache_line_size / sizeof(T)};
+				return (K + per_line - 1) / per_line * per_line;
+			}
+			else {
+				return K;
+			}
+		}
+
+	}//!namespace details
+
+	/**
+	 * K series sharing one time axis: an N x K matrix, one row per time step,
+	 * with a single head index for all the series.
+	 * */
+	template <typename T, std::size_t N, std::size_t K>
+	requires (N > 0 && K > 0)
+	class CircularBufferBank {
+	public:
+		using value_type = T;
+
+		static constexpr std::size_t stride {details::row_stride<T, K>()};
+
+		class ColumnView {
+		public:
+			ColumnView (T const* data, std::size_t front_idx, std::size_t sz, std::size_t col) noexcept
+					: data      {data}
+					, front_idx {front_idx}
+					, sz        {sz}
+					, col       {col}
+			{}
+
+			T const& operator[](std::size_t idx) const noexcept {
+				return data[get_row_idx(front_idx, idx) * stride + col];
+			}
+
+			T const& front() const noexcept {
+				return (*this)[0];
+			}
+
+			T const& back() const noexcept {
+				return (*this)[sz - 1];
+			}
+
+			std::size_t size() const noexcept {
+				return sz;
+			}
+
+		private:
+			T const* data;
+			std::size_t front_idx, sz, col;
+		};
+
+		explicit CircularBufferBank ()
+		requires std::is_default_constructible_v<T>
+				: sz        {0}
+				, front_idx {0}
+				, back_idx  {N - 1}
+		{
+			data.fill(T{});
+		}
+
+		void push_row(std::span<T const, K> row) noexcept {
+			++back_idx;
+			if (back_idx == N) [[unlikely]] {
+				back_idx = 0;
+			}
+			if (sz < N) [[likely]] {
+				++sz;
+			}
+			else {
+				++front_idx;
+				if (front_idx == N) [[unlikely]] {
+					front_idx = 0;
+				}
+			}
+			std::copy(row.begin(), row.end(), data.begin() + back_idx * stride);
+		}
+
+		void pop_front_row() noexcept {
+			if (sz == 0u) [[unlikely]] {
+				return;
+			}
+			--sz;
+			++front_idx;
+			if (front_idx == N) [[unlikely]] {
+				front_idx = 0;
+			}
+		}
+
+		/**
+		 * Logical row, 0 is the oldest time step.
+		 * */
+		std::span<T const, K> row(std::size_t idx) const noexcept {
+			return std::span<T const, K>(data.data() + get_row_idx(front_idx, idx) * stride, K);
+		}
+
+		std::span<T const, K> front_row() const noexcept {
+			return row(0);
+		}
+
+		std::span<T const, K> back_row() const noexcept {
+			return std::span<T const, K>(data.data() + back_idx * stride, K);
+		}
+
+		ColumnView column(std::size_t col) const noexcept {
+			return ColumnView(data.data(), front_idx, sz, col);
+		}
+
+		T const& at(std::size_t idx, std::size_t col) const {
+			if (idx >= sz || col >= K) {
+				throw std::out_of_range("CircularBufferBank is out of range with idx "
+										+ std::to_string(idx) + ", col " + std::to_string(col));
+			}
+			return data[get_row_idx(front_idx, idx) * stride + col];
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+		static constexpr std::size_t series_count() noexcept {
+			return K;
+		}
+
+		std::size_t size() const noexcept {
+			return sz;
+		}
+
+		bool empty() const noexcept {
+			return sz == 0u;
+		}
+
+	private:
+		alignas(details::cache_line_size) std::array<T, N * stride> data;
+		std::size_t sz;
+		std::size_t front_idx, back_idx;
+
+		static std::size_t get_row_idx (std::size_t front_idx, std::size_t idx) noexcept {
+			idx += front_idx;
+			return idx < N ? idx : idx - N;
+		}
+	};
+
+}//!namespace containers
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "circular_buffer_fixed.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace containers {
+
+	/**
+	 * Describes one rollup level of a cascade: a ring of N aggregates,
+	 * each aggregate covering Period consecutive items of the level below.
+	 * */
+	template <std::size_t N, std::size_t Period>
+	requires (N > 0 && Period > 0)
+	struct CascadeLevel {
+		static constexpr std::size_t capacity = N;
+		static constexpr std::size_t period = Period;
+	};
+
+	/**
+	 * A reducer turns a raw sample into an aggregate (lift) and folds
+	 * the next aggregate into an accumulated one (combine). The first
+	 * aggregate of a period is copied as is, so no identity value is needed.
+	 * */
+	template <typename R, typename T>
+	concept CascadeReducer = requires (T const& t,
+									   typename R::aggregate_type& acc,
+									   typename R::aggregate_type const& next) {
+		typename R::aggregate_type;
+		{ R::lift(t) } -> std::convertible_to<typename R::aggregate_type>;
+		{ R::combine(acc, next) };
+	};
+
+	namespace reducers {
+
+		template <typename T>
+		struct Bar {
+			T open, high, low, close, sum;
+			std::int64_t count;
+		};
+
+		template <typename T>
+		struct OHLC {
+			using aggregate_type = Bar<T>;
+
+			static aggregate_type lift(T const& t) noexcept {
+				return {t, t, t, t, t, 1};
+			}
+
+			static void combine(aggregate_type& acc, aggregate_type const& next) noexcept {
+				acc.high = std::max(acc.high, next.high);
+				acc.low = std::min(acc.low, next.low);
+				acc.close = next.close;
+				acc.sum += next.sum;
+				acc.count += next.count;
+			}
+		};
+
+	}//!namespace reducers
+
+	/**
+	 * Level 0 keeps the raw samples, every next level keeps aggregates of the
+	 * previous one. Rollups are done incrementally on push_back, so there is
+	 * neither allocation nor a full-window recomputation at period boundaries.
+	 * */
+	template <typename T, typename Reducer, std::size_t BaseN, typename... Levels>
+	requires CascadeReducer<Reducer, T> && (sizeof...(Levels) > 0)
+	class CircularBufferCascade {
+	public:
+		using value_type = T;
+		using aggregate_type = typename Reducer::aggregate_type;
+
+		static constexpr std::size_t levels_count {sizeof...(Levels) + 1};
+
+		void push_back(T t) {
+			accumulate<1>(Reducer::lift(t));
+			base.push_back(std::move(t));
+		}
+
+		template <std::size_t Level>
+		requires (Level < levels_count)
+		auto const& level() const noexcept {
+			if constexpr (Level == 0) {
+				return base;
+			}
+			else {
+				return std::get<Level - 1>(rollups);
+			}
+		}
+
+		/**
+		 * Aggregate of the period that is not completed yet,
+		 * valid only if partial_count<Level>() is not zero.
+		 * */
+		template <std::size_t Level>
+		requires (Level > 0 && Level < levels_count)
+		aggregate_type const& partial() const noexcept {
+			return acc[Level - 1];
+		}
+
+		template <std::size_t Level>
+		requires (Level > 0 && Level < levels_count)
+		std::size_t partial_count() const noexcept {
+			return cnt[Level - 1];
+		}
+
+	private:
+		CircularBufferFixed<T, BaseN> base;
+		std::tuple<CircularBufferFixed<aggregate_type, Levels::capacity>...> rollups;
+		std::array<aggregate_type, sizeof...(Levels)> acc;
+		std::array<std::size_t, sizeof...(Levels)> cnt {};
+
+		template <std::size_t Level>
+		void accumulate(aggregate_type const& next) {
+			constexpr std::size_t i {Level - 1};
+			using level_type = std::tuple_element_t<i, std::tuple<Levels...>>;
+
+			if (cnt[i] == 0u) {
+				acc[i] = next;
+			}
+			else {
+				Reducer::combine(acc[i], next);
+			}
+			if (++cnt[i] == level_type::period) [[unlikely]] {
+				cnt[i] = 0u;
+				if constexpr (Level + 1 < levels_count) {
+					accumulate<Level + 1>(acc[i]);
+				}
+				std::get<i>(rollups).push_back(acc[i]);
+			}
+		}
+	};
+
+}//!namespace containers
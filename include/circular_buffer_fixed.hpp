@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "buffer_stats.hpp"
+
 #include <iostream>
 #include <array>
 #include <type_traits>
@@ -12,17 +14,68 @@
 #include <stdexcept>
 #include <utility>
 #include <concepts>
+#include <limits>
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <cstring>
 
 namespace containers {
 
-	template <typename T, std::int32_t N>
-	requires (requires {N > 0;})
+	namespace details {
+
+		/**
+		 * The smallest unsigned type that holds every index and size of a ring of N.
+		 * */
+		template <std::size_t N>
+		using index_type_for_t =
+				std::conditional_t<N <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+				std::conditional_t<N <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+				std::conditional_t<N <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t,
+						std::uint64_t>>>;
+
+		template <std::size_t N, typename Index>
+		concept ring_capacity = std::unsigned_integral<Index> && N > 0u && N <= std::numeric_limits<Index>::max();
+
+		inline constexpr std::size_t tiny_window_bytes {64};
+
+		/**
+		 * A window that fits one or two SIMD registers, N <= 8 doubles or N <= 16 floats.
+		 * */
+		template <typename T, std::size_t N>
+		concept tiny_window = std::is_floating_point_v<T> && N * sizeof(T) <= tiny_window_bytes;
+
+		/**
+		 * Below this storage size a plain copy of the whole array is a few vector moves
+		 * and beats copying the window piecewise, the container stays trivially copyable.
+		 * */
+		inline constexpr std::size_t windowed_copy_min_bytes {256};
+
+		/**
+		 * Elements that can be copied with memcpy into storage that is never initialized,
+		 * in storage large enough for copying only the window to pay off.
+		 * */
+		template <typename T, std::size_t N>
+		concept windowed_copy = std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>
+				&& N * sizeof(T) > windowed_copy_min_bytes;
+
+	}//!namespace details
+
+	/**
+	 * Index is the type of the size and both indices, by default
+	 * it is the smallest unsigned type that holds N.
+	 * Stats is a statistics policy, see buffer_stats.hpp, stats::Null costs nothing.
+	 * */
+	template <typename T, std::size_t N, typename Index = details::index_type_for_t<N>, typename Stats = stats::Null>
+	requires details::ring_capacity<N, Index>
 	class CircularBufferFixed {
 	public:
-		using container_type = CircularBufferFixed<T, 0>;
+		using container_type = CircularBufferFixed<T, N, Index, Stats>;
 		using value_type = T;
+		using index_type = Index;
+		using stats_type = Stats;
 
-		explicit CircularBufferFixed ()
+		constexpr explicit CircularBufferFixed ()
 		requires std::is_default_constructible_v<T>
 				: sz        {0}
 				, front_idx {0}
@@ -31,7 +84,7 @@ namespace containers {
 			data.fill(T{});
 		}
 
-		explicit CircularBufferFixed (T defaultValue)
+		constexpr explicit CircularBufferFixed (T defaultValue)
 				: sz        {N}
 				, front_idx {0}
 				, back_idx 	{N - 1}
@@ -39,7 +92,54 @@ namespace containers {
 			data.fill(defaultValue);
 		}
 
-		void push_back(T t) noexcept {
+		/**
+		 * Trivially copyable elements in storage above windowed_copy_min_bytes are copied
+		 * only where the window is, with at most two memcpy at the same positions;
+		 * slots outside the window are unspecified in the copy. A move is the same copy.
+		 * Smaller buffers keep the defaulted, trivial copy.
+		 * */
+		constexpr CircularBufferFixed (CircularBufferFixed const& other) noexcept
+		requires details::windowed_copy<T, N>
+				: sz           {other.sz}
+				, front_idx    {other.front_idx}
+				, back_idx     {other.back_idx}
+				, stats_policy {other.stats_policy}
+		{
+			copy_window(other);
+		}
+
+		constexpr CircularBufferFixed (CircularBufferFixed const&) = default;
+
+		constexpr CircularBufferFixed (CircularBufferFixed&& other) noexcept
+		requires details::windowed_copy<T, N>
+				: CircularBufferFixed(std::as_const(other))
+		{}
+
+		constexpr CircularBufferFixed (CircularBufferFixed&&) = default;
+
+		constexpr CircularBufferFixed& operator=(CircularBufferFixed const& other) noexcept
+		requires details::windowed_copy<T, N> {
+			if (this != &other) {
+				sz = other.sz;
+				front_idx = other.front_idx;
+				back_idx = other.back_idx;
+				stats_policy = other.stats_policy;
+				copy_window(other);
+			}
+			return *this;
+		}
+
+		constexpr CircularBufferFixed& operator=(CircularBufferFixed const&) = default;
+
+		constexpr CircularBufferFixed& operator=(CircularBufferFixed&& other) noexcept
+		requires details::windowed_copy<T, N> {
+			return *this = std::as_const(other);
+		}
+
+		constexpr CircularBufferFixed& operator=(CircularBufferFixed&&) = default;
+
+		constexpr void push_back(T t) noexcept {
+			bool const overwrites = sz == N;
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(likely)
 			if (sz != 0u) [[likely]] {
@@ -60,9 +160,11 @@ namespace containers {
 			throw std::runtime_error ("This is some kind of a wrong C++. Check your planet.");
 #endif
 			data[back_idx] = std::move(t);
+			stats_policy.on_push(overwrites, sz);
 		}
 
-		void push_front(T t) noexcept {
+		constexpr void push_front(T t) noexcept {
+			bool const overwrites = sz == N;
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(likely)
 			if (sz != 0u) [[likely]] {
@@ -83,9 +185,11 @@ namespace containers {
 			throw std::runtime_error ("This is some kind of a wrong C++. Check your planet.");
 #endif
 			data[front_idx] = std::move(t);
+			stats_policy.on_push(overwrites, sz);
 		}
 
-		T& pop_back() noexcept {
+		constexpr T& pop_back() noexcept {
+			stats_policy.on_pop(sz == 0u);
 			T& res = data[back_idx];
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(likely)
@@ -110,7 +214,8 @@ namespace containers {
 			return res;
 		}
 
-		T& pop_front() noexcept {
+		constexpr T& pop_front() noexcept {
+			stats_policy.on_pop(sz == 0u);
 			T& res = data[front_idx];
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(likely)
@@ -134,23 +239,23 @@ namespace containers {
 			return res;
 		}
 
-		T& front() noexcept {
+		constexpr T& front() noexcept {
 			return data[front_idx];
 		}
 
-		T const& front() const {
+		constexpr T const& front() const {
 			return data.at(front_idx);
 		}
 
-		T& back() noexcept {
+		constexpr T& back() noexcept {
 			return data[back_idx];
 		}
 
-		T const& back() const {
+		constexpr T const& back() const {
 			return data.at(back_idx);
 		}
 
-		T& at(std::size_t idx) {
+		constexpr T& at(std::size_t idx) {
 			auto idx_ = get_idx(idx);
 			if (idx_ >= N) {
 				throw std::out_of_range("CircularBufferFixed is out of range with idx " + std::to_string(idx));
@@ -158,7 +263,7 @@ namespace containers {
 			return data[idx_];
 		}
 
-		T const& at(std::size_t idx) const {
+		constexpr T const& at(std::size_t idx) const {
 			auto idx_ = get_idx(idx);
 			if (idx_ >= N) {
 				throw std::out_of_range("CircularBufferFixed is out of range with idx " + std::to_string(idx));
@@ -166,29 +271,160 @@ namespace containers {
 			return data.at(idx_);
 		}
 
-		T& operator[](std::size_t idx) noexcept {
+		constexpr T& operator[](std::size_t idx) noexcept {
 			auto idx_ = get_idx(idx);
 			return data[idx_];
 		}
 
-		static constexpr std::int32_t capacity() noexcept {
+		constexpr T const& operator[](std::size_t idx) const noexcept {
+			return data[get_idx(idx)];
+		}
+
+		/**
+		 * The window as at most two contiguous pieces of storage: array_one() holds
+		 * the oldest elements, array_two() is empty unless the window wraps.
+		 * */
+		constexpr std::span<T> array_one() noexcept {
+			return std::span<T>(data.data() + front_idx, first_part());
+		}
+
+		constexpr std::span<T const> array_one() const noexcept {
+			return std::span<T const>(data.data() + front_idx, first_part());
+		}
+
+		constexpr std::span<T> array_two() noexcept {
+			return std::span<T>(data.data(), sz - first_part());
+		}
+
+		constexpr std::span<T const> array_two() const noexcept {
+			return std::span<T const>(data.data(), sz - first_part());
+		}
+
+		/**
+		 * Free slots after the newest element in push_back order, at most two pieces.
+		 * They are filled in place and then made part of the window with commit_back().
+		 * */
+		constexpr std::span<T> free_array_one() noexcept {
+			std::size_t const first = free_pos();
+			return std::span<T>(data.data() + first, std::min(N - sz, N - first));
+		}
+
+		constexpr std::span<T> free_array_two() noexcept {
+			return std::span<T>(data.data(), N - sz - free_array_one().size());
+		}
+
+		/**
+		 * Appends the first n free slots to the window, n <= capacity() - size().
+		 * */
+		constexpr void commit_back(std::size_t n) noexcept {
+			std::size_t const before = sz;
+			sz = static_cast<Index>(before + n);
+			back_idx = static_cast<Index>((front_idx + std::max<std::size_t>(sz, 1u) - 1u) % N);
+			for (std::size_t i = 1; i <= n; ++i) {
+				stats_policy.on_push(false, before + i);
+			}
+		}
+
+		/**
+		 * Moves the window in place so that the oldest element is at index 0,
+		 * returns it as one contiguous span. Only live slots are read, in O(size()):
+		 * a wrapped window first closes the free gap, then rotates the two pieces.
+		 * */
+		constexpr std::span<T> linearize() noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_swappable_v<T>) {
+			if (front_idx != 0u) {
+				std::size_t const one = first_part();
+				std::size_t const two = sz - one;
+				//[two][gap][one] -> [two][one][gap] -> [one][two][gap]
+				if (front_idx != two) {
+					std::move(data.begin() + front_idx, data.begin() + front_idx + one, data.begin() + two);
+				}
+				std::rotate(data.begin(), data.begin() + two, data.begin() + sz);
+				front_idx = 0;
+				back_idx = static_cast<Index>(std::max<std::size_t>(sz, 1u) - 1u);
+			}
+			return std::span<T>(data.data(), sz);
+		}
+
+		/**
+		 * Touches only the slots where either window is: slots live in both are swapped,
+		 * slots live in one are moved to the other, indices and sizes are exchanged.
+		 * */
+		constexpr void swap(CircularBufferFixed& other) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_swappable_v<T>) {
+			std::array<std::pair<std::size_t, std::size_t>, 2> const mine {live_range_one(), live_range_two()};
+			std::array<std::pair<std::size_t, std::size_t>, 2> const theirs {other.live_range_one(), other.live_range_two()};
+			std::array<std::size_t, 10> bounds {0, N};
+			std::size_t count {2};
+			for (auto const& ranges : {mine, theirs}) {
+				for (auto [begin, end] : ranges) {
+					bounds[count++] = begin;
+					bounds[count++] = end;
+				}
+			}
+			std::sort(bounds.begin(), bounds.begin() + count);
+			auto const live = [](auto const& ranges, std::size_t pos) {
+				return std::any_of(ranges.begin(), ranges.end(), [pos](auto const& range) {
+					return range.first <= pos && pos < range.second;
+				});
+			};
+			for (std::size_t b = 0; b + 1 < count; ++b) {
+				std::size_t const begin = bounds[b], end = bounds[b + 1];
+				if (begin == end) {
+					continue;
+				}
+				bool const in_mine = live(mine, begin);
+				bool const in_theirs = live(theirs, begin);
+				auto const from = data.begin() + begin, to = data.begin() + end;
+				auto const other_from = other.data.begin() + begin;
+				if (in_mine && in_theirs) {
+					std::swap_ranges(from, to, other_from);
+				}
+				else if (in_mine) {
+					std::move(from, to, other_from);
+				}
+				else if (in_theirs) {
+					std::move(other_from, other.data.begin() + end, from);
+				}
+			}
+			std::swap(sz, other.sz);
+			std::swap(front_idx, other.front_idx);
+			std::swap(back_idx, other.back_idx);
+			std::swap(stats_policy, other.stats_policy);
+		}
+
+		friend constexpr void swap(CircularBufferFixed& lhs, CircularBufferFixed& rhs)
+				noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_swappable_v<T>) {
+			lhs.swap(rhs);
+		}
+
+		static constexpr std::size_t capacity() noexcept {
 			return N;
 		}
 
-		std::size_t size() const noexcept {
+		constexpr std::size_t size() const noexcept {
 			return sz;
 		}
 
-		bool empty() const noexcept {
+		constexpr bool empty() const noexcept {
 			return sz == 0u;
 		}
 
+		constexpr stats::Snapshot stats() const noexcept
+		requires (not std::is_same_v<Stats, stats::Null>) {
+			return stats_policy.snapshot();
+		}
+
+		constexpr void reset_stats() noexcept
+		requires (not std::is_same_v<Stats, stats::Null>) {
+			stats_policy.reset();
+		}
+
 	private:
 		std::array<T, N> data;
-		std::int32_t sz;
-		std::int32_t front_idx, back_idx;
+		Index sz;
+		Index front_idx, back_idx;
+		[[no_unique_address]] Stats stats_policy;
 
-		inline void update_on_push_back() noexcept {
+		constexpr void update_on_push_back() noexcept {
 			++back_idx;
 
 #ifdef __has_cpp_attribute
@@ -218,28 +454,29 @@ namespace containers {
 #endif
 		}
 
-		void update_on_push_front() noexcept {
-			--front_idx;
+		constexpr void update_on_push_front() noexcept {
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(unlikely)
-			if (front_idx == -1) [[unlikely]] {
-				front_idx = N - 1;
+			if (front_idx == 0u) [[unlikely]] {
+				front_idx = N;
 			}
+			--front_idx;
 			if(front_idx == back_idx) [[unlikely]] {
-				--back_idx;
-				if (back_idx == -1) [[unlikely]] {
-					back_idx = N - 1;
+				if (back_idx == 0u) [[unlikely]] {
+					back_idx = N;
 				}
+				--back_idx;
 			}
 	#else
-			if (__builtin_expect(front_idx == -1), 0){
-				front_idx = cap - 1;
+			if (__builtin_expect(front_idx == 0u, 0)) {
+				front_idx = N;
 			}
-			if(__builtin_expect(front_idx == back_idx), 0) {
-				--back_idx;
-				if (__builtin_expect(back_idx == -1), 0) {
-					back_idx = cap - 1;
+			--front_idx;
+			if(__builtin_expect(front_idx == back_idx, 0)) {
+				if (__builtin_expect(back_idx == 0u, 0)) {
+					back_idx = N;
 				}
+				--back_idx;
 			}
 	#endif
 #else
@@ -247,25 +484,24 @@ namespace containers {
 #endif
 		}
 
-		inline void update_on_pop_back() noexcept {
-			--back_idx;
-
+		constexpr void update_on_pop_back() noexcept {
 #ifdef __has_cpp_attribute
 	#if __has_cpp_attribute(unlikely)
-			if (back_idx == -1) [[unlikely]] {
-				back_idx = N - 1;
+			if (back_idx == 0u) [[unlikely]] {
+				back_idx = N;
 			}
 	#else
-			if (__builtin_expect(back_idx == -1, 0)) {
-				back_idx = cap - 1;
+			if (__builtin_expect(back_idx == 0u, 0)) {
+				back_idx = N;
 			}
 	#endif
 #else
 			throw std::runtime_error ("This is some kind of a wrong C++. Check your planet.");
 #endif
+			--back_idx;
 		}
 
-		inline void update_on_pop_front() noexcept {
+		constexpr void update_on_pop_front() noexcept {
 			++front_idx;
 
 #ifdef __has_cpp_attribute
@@ -283,12 +519,275 @@ namespace containers {
 #endif
 		}
 
-		inline std::int32_t get_idx (std::size_t idx) const noexcept {
-			auto idx_ = static_cast<std::int32_t>(idx);
-			idx_ += front_idx;
-			idx_ %= N;
-			return idx_;
+		constexpr std::size_t first_part() const noexcept {
+			return std::min<std::size_t>(sz, N - front_idx);
+		}
+
+		constexpr std::size_t free_pos() const noexcept {
+			return (static_cast<std::size_t>(front_idx) + sz) % N;
+		}
+
+		constexpr std::pair<std::size_t, std::size_t> live_range_one() const noexcept {
+			return {front_idx, front_idx + first_part()};
+		}
+
+		constexpr std::pair<std::size_t, std::size_t> live_range_two() const noexcept {
+			return {0u, sz - first_part()};
+		}
+
+		constexpr void copy_window(CircularBufferFixed const& other) noexcept {
+			if (std::is_constant_evaluated()) {
+				//a constant has no indeterminate slots, so the whole storage is copied
+				std::copy(other.data.begin(), other.data.end(), data.begin());
+				return;
+			}
+			std::size_t const one = other.first_part();
+			std::memcpy(data.data() + other.front_idx, other.data.data() + other.front_idx, one * sizeof(T));
+			std::memcpy(data.data(), other.data.data(), (other.sz - one) * sizeof(T));
+		}
+
+		constexpr std::size_t get_idx (std::size_t idx) const noexcept {
+			idx += front_idx;
+			idx %= N;
+			return idx;
 		}
 	};
 
+	/**
+	 * Tiny windows are kept linear instead of circular: the window always
+	 * occupies the tail of the storage, oldest at N - size(), newest at N - 1.
+	 * push_back is a shift-by-one and an insert, which the compiler lowers
+	 * to a couple of vector loads and stores, and there are no indices to wrap.
+	 * */
+	template <typename T, std::size_t N, typename Index, typename Stats>
+	requires details::ring_capacity<N, Index> && details::tiny_window<T, N>
+	class CircularBufferFixed<T, N, Index, Stats> {
+	public:
+		using container_type = CircularBufferFixed<T, N, Index, Stats>;
+		using value_type = T;
+		using index_type = Index;
+		using stats_type = Stats;
+
+		constexpr explicit CircularBufferFixed ()
+				: sz {0}
+		{
+			data.fill(T{});
+		}
+
+		constexpr explicit CircularBufferFixed (T defaultValue)
+				: sz {N}
+		{
+			data.fill(defaultValue);
+		}
+
+		constexpr void push_back(T t) noexcept {
+			bool const overwrites = sz == N;
+			shift_left(t);
+			if (sz < N) [[likely]] {
+				++sz;
+			}
+			stats_policy.on_push(overwrites, sz);
+		}
+
+		constexpr void push_front(T t) noexcept {
+			bool const overwrites = sz == N;
+			if (sz < N) [[likely]] {
+				++sz;
+			}
+			else {
+				shift_right(data[N - 1]);
+			}
+			data[N - sz] = t;
+			stats_policy.on_push(overwrites, sz);
+		}
+
+		/**
+		 * The only operation that moves data: the shift rotates the popped
+		 * element into data[0], outside the window, and the returned reference
+		 * stays valid until the next push.
+		 * */
+		constexpr T& pop_back() noexcept {
+			stats_policy.on_pop(sz == 0u);
+			if (sz == 0u) [[unlikely]] {
+				return data[N - 1];
+			}
+			shift_right(data[N - 1]);
+			--sz;
+			return data[0];
+		}
+
+		constexpr T& pop_front() noexcept {
+			stats_policy.on_pop(sz == 0u);
+			T& res = data[front_pos()];
+			if (sz > 0) [[likely]] {
+				--sz;
+			}
+			return res;
+		}
+
+		constexpr T& front() noexcept {
+			return data[front_pos()];
+		}
+
+		constexpr T const& front() const noexcept {
+			return data[front_pos()];
+		}
+
+		constexpr T& back() noexcept {
+			return data[N - 1];
+		}
+
+		constexpr T const& back() const noexcept {
+			return data[N - 1];
+		}
+
+		constexpr T& at(std::size_t idx) {
+			auto idx_ = get_idx(idx);
+			if (idx_ >= N) {
+				throw std::out_of_range("CircularBufferFixed is out of range with idx " + std::to_string(idx));
+			}
+			return data[idx_];
+		}
+
+		constexpr T const& at(std::size_t idx) const {
+			auto idx_ = get_idx(idx);
+			if (idx_ >= N) {
+				throw std::out_of_range("CircularBufferFixed is out of range with idx " + std::to_string(idx));
+			}
+			return data[idx_];
+		}
+
+		constexpr T& operator[](std::size_t idx) noexcept {
+			return data[get_idx(idx)];
+		}
+
+		constexpr T const& operator[](std::size_t idx) const noexcept {
+			return data[get_idx(idx)];
+		}
+
+		/**
+		 * The window is always contiguous, oldest to newest.
+		 * */
+		constexpr std::span<T const> window() const noexcept {
+			return std::span<T const>(data.data() + (N - sz), sz);
+		}
+
+		constexpr std::span<T> array_one() noexcept {
+			return std::span<T>(data.data() + (N - sz), sz);
+		}
+
+		constexpr std::span<T const> array_one() const noexcept {
+			return window();
+		}
+
+		constexpr std::span<T> array_two() noexcept {
+			return {};
+		}
+
+		constexpr std::span<T const> array_two() const noexcept {
+			return {};
+		}
+
+		/**
+		 * Free slots are the head of the storage, commit_back() rotates
+		 * the freshly filled ones behind the window.
+		 * */
+		constexpr std::span<T> free_array_one() noexcept {
+			return std::span<T>(data.data(), N - sz);
+		}
+
+		constexpr std::span<T> free_array_two() noexcept {
+			return {};
+		}
+
+		constexpr void commit_back(std::size_t n) noexcept {
+			std::rotate(data.begin(), data.begin() + n, data.end());
+			std::size_t const before = sz;
+			sz = static_cast<Index>(before + n);
+			for (std::size_t i = 1; i <= n; ++i) {
+				stats_policy.on_push(false, before + i);
+			}
+		}
+
+		/**
+		 * Already linear, the window is returned where it is: at the tail of the storage.
+		 * */
+		constexpr std::span<T> linearize() noexcept {
+			return array_one();
+		}
+
+		constexpr void swap(CircularBufferFixed& other) noexcept {
+			std::swap(data, other.data);
+			std::swap(sz, other.sz);
+			std::swap(stats_policy, other.stats_policy);
+		}
+
+		friend constexpr void swap(CircularBufferFixed& lhs, CircularBufferFixed& rhs) noexcept {
+			lhs.swap(rhs);
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+		constexpr std::size_t size() const noexcept {
+			return sz;
+		}
+
+		constexpr bool empty() const noexcept {
+			return sz == 0u;
+		}
+
+		constexpr stats::Snapshot stats() const noexcept
+		requires (not std::is_same_v<Stats, stats::Null>) {
+			return stats_policy.snapshot();
+		}
+
+		constexpr void reset_stats() noexcept
+		requires (not std::is_same_v<Stats, stats::Null>) {
+			stats_policy.reset();
+		}
+
+	private:
+		alignas(std::bit_ceil(N * sizeof(T))) std::array<T, N> data;
+		Index sz;
+		[[no_unique_address]] Stats stats_policy;
+
+		/**
+		 * Wraps like the ring does, so any index stays inside the storage.
+		 * */
+		constexpr std::size_t get_idx (std::size_t idx) const noexcept {
+			return (N - sz + idx) % N;
+		}
+
+		constexpr std::size_t front_pos() const noexcept {
+			return N - std::max<std::size_t>(sz, 1u);
+		}
+
+		/**
+		 * Shifts rebuild the window from a pack expansion: the compiler keeps it
+		 * in registers as loads, a permute and aligned stores, not a memmove.
+		 * */
+		constexpr void shift_left(T t) noexcept {
+			data = shifted_left(t, std::make_index_sequence<N - 1>{});
+		}
+
+		constexpr void shift_right(T t) noexcept {
+			data = shifted_right(t, std::make_index_sequence<N - 1>{});
+		}
+
+		template <std::size_t... I>
+		constexpr std::array<T, N> shifted_left(T t, std::index_sequence<I...>) const noexcept {
+			return {data[I + 1]..., t};
+		}
+
+		template <std::size_t... I>
+		constexpr std::array<T, N> shifted_right(T t, std::index_sequence<I...>) const noexcept {
+			return {t, data[I]...};
+		}
+	};
+
+	template <typename T, std::size_t N, typename Stats>
+	using CircularBufferFixedWithStats = CircularBufferFixed<T, N, details::index_type_for_t<N>, Stats>;
+
 }//!namespace containers
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "circular_buffer_fixed.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * The io_uring backend is opt-in: define CONTAINERS_IO_URING and link with -luring.
+ * */
+#if defined(CONTAINERS_IO_URING) && __has_include(<liburing.h>)
+	#include <liburing.h>
+	#include <cstdint>
+	#include <vector>
+	#define CONTAINERS_HAS_IO_URING 1
+#endif
+
+namespace containers {
+
+	namespace details {
+
+		/**
+		 * A buffer that exposes its window and its free space as contiguous pieces.
+		 * */
+		template <typename Buffer>
+		concept segmented_buffer = std::is_trivially_copyable_v<typename Buffer::value_type>
+				&& requires (Buffer& b, Buffer const& cb, std::size_t n) {
+			{ cb.array_one() } -> std::convertible_to<std::span<typename Buffer::value_type const>>;
+			{ cb.array_two() } -> std::convertible_to<std::span<typename Buffer::value_type const>>;
+			{ b.free_array_one() } -> std::convertible_to<std::span<typename Buffer::value_type>>;
+			{ b.free_array_two() } -> std::convertible_to<std::span<typename Buffer::value_type>>;
+			b.commit_back(n);
+		};
+
+		/**
+		 * Empty pieces are left out, returns the number of iovecs filled.
+		 * */
+		template <typename T>
+		int to_iovecs(std::span<T> one, std::span<T> two, std::array<iovec, 2>& iov) noexcept {
+			int count {0};
+			for (auto piece : {one, two}) {
+				if (not piece.empty()) {
+					iov[count].iov_base = const_cast<std::remove_const_t<T>*>(piece.data());
+					iov[count].iov_len = piece.size_bytes();
+					++count;
+				}
+			}
+			return count;
+		}
+
+		inline void advance(iovec*& iov, int& count, std::size_t bytes) noexcept {
+			while (count != 0 && bytes >= iov->iov_len) {
+				bytes -= iov->iov_len;
+				++iov;
+				--count;
+			}
+			if (count != 0) {
+				iov->iov_base = static_cast<std::byte*>(iov->iov_base) + bytes;
+				iov->iov_len -= bytes;
+			}
+		}
+
+	}//!namespace details
+
+	/**
+	 * Writes the whole window, oldest to newest, straight from the storage:
+	 * one writev over its one or two pieces, repeated only on a short write.
+	 * The buffer is left intact. Meant for blocking descriptors,
+	 * throws std::system_error on failure. Returns the number of bytes written.
+	 * */
+	template <typename Buffer>
+	requires details::segmented_buffer<Buffer>
+	std::size_t write_to(Buffer const& buffer, int fd) {
+		std::array<iovec, 2> iovs;
+		int count = details::to_iovecs(buffer.array_one(), buffer.array_two(), iovs);
+		iovec* iov = iovs.data();
+		std::size_t total {0};
+		while (count != 0) {
+			ssize_t const written = ::writev(fd, iov, count);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw std::system_error(errno, std::generic_category(), "write_to");
+			}
+			if (written == 0) {
+				throw std::system_error(EIO, std::generic_category(), "write_to wrote nothing");
+			}
+			total += static_cast<std::size_t>(written);
+			details::advance(iov, count, static_cast<std::size_t>(written));
+		}
+		return total;
+	}
+
+	/**
+	 * Reads into the free space behind the newest element with one readv
+	 * and appends what has been read to the window, nothing is overwritten.
+	 * A read that stops inside an element is completed with further reads,
+	 * which is what blocking descriptors are for: on a non-blocking one the
+	 * bytes of that element are lost if the rest isn't there yet.
+	 * Whole elements read are appended before anything throws: a stream that
+	 * ends inside an element throws std::runtime_error, other failures throw
+	 * std::system_error. Returns the number of elements appended, 0 at EOF,
+	 * when the buffer is full or when nothing is ready yet (EAGAIN).
+	 * */
+	template <typename Buffer>
+	requires details::segmented_buffer<Buffer>
+	std::size_t read_from(Buffer& buffer, int fd) {
+		using value_type = typename Buffer::value_type;
+		auto const one = buffer.free_array_one();
+		auto const two = buffer.free_array_two();
+		std::array<iovec, 2> iovs;
+		int const count = details::to_iovecs(one, two, iovs);
+		if (count == 0) {
+			return 0;
+		}
+		ssize_t got;
+		do {
+			got = ::readv(fd, iovs.data(), count);
+		} while (got < 0 && errno == EINTR);
+		if (got < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return 0;
+			}
+			throw std::system_error(errno, std::generic_category(), "read_from");
+		}
+		std::size_t bytes = static_cast<std::size_t>(got);
+		//pieces hold whole elements, so the rest of an element is contiguous
+		while (bytes % sizeof(value_type) != 0u) {
+			std::byte* const where = bytes < one.size_bytes()
+					? reinterpret_cast<std::byte*>(one.data()) + bytes
+					: reinterpret_cast<std::byte*>(two.data()) + (bytes - one.size_bytes());
+			ssize_t const more = ::read(fd, where, sizeof(value_type) - bytes % sizeof(value_type));
+			if (more < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				int const error = errno;
+				buffer.commit_back(bytes / sizeof(value_type));
+				throw std::system_error(error, std::generic_category(), "read_from");
+			}
+			if (more == 0) {
+				buffer.commit_back(bytes / sizeof(value_type));
+				throw std::runtime_error("read_from: stream ended inside an element");
+			}
+			bytes += static_cast<std::size_t>(more);
+		}
+		std::size_t const elements = bytes / sizeof(value_type);
+		buffer.commit_back(elements);
+		return elements;
+	}
+
+#ifdef CONTAINERS_HAS_IO_URING
+
+	/**
+	 * Writes of many buffers handed to the kernel with a single submission.
+	 * Buffers must stay unchanged until submit() returns; short writes
+	 * are reported rather than retried.
+	 * */
+	class UringWriteBatch {
+	public:
+		explicit UringWriteBatch (unsigned entries)
+				: iovecs (entries)
+		{
+			if (int const err = io_uring_queue_init(entries, &uring, 0); err < 0) {
+				throw std::system_error(-err, std::generic_category(), "io_uring_queue_init");
+			}
+		}
+
+		UringWriteBatch (UringWriteBatch const&) = delete;
+		UringWriteBatch& operator=(UringWriteBatch const&) = delete;
+
+		~UringWriteBatch() {
+			io_uring_queue_exit(&uring);
+		}
+
+		/**
+		 * Queues the window of buffer, offset -1 writes at the current file position.
+		 * Returns false if the batch is full.
+		 * */
+		template <typename Buffer>
+		requires details::segmented_buffer<Buffer>
+		bool add(Buffer const& buffer, int fd, std::uint64_t offset = static_cast<std::uint64_t>(-1)) {
+			if (queued == iovecs.size()) {
+				return false;
+			}
+			io_uring_sqe* sqe = io_uring_get_sqe(&uring);
+			if (not sqe) {
+				return false;
+			}
+			auto& iov = iovecs[queued];
+			int const count = details::to_iovecs(buffer.array_one(), buffer.array_two(), iov);
+			io_uring_prep_writev(sqe, fd, iov.data(), static_cast<unsigned>(count), offset);
+			io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<std::uintptr_t>(queued)));
+			++queued;
+			return true;
+		}
+
+		/**
+		 * Submits everything queued and waits for it, the i-th result
+		 * is the byte count or -errno of the i-th add().
+		 * */
+		std::vector<long> submit() {
+			std::vector<long> results (queued);
+			if (int const err = io_uring_submit_and_wait(&uring, queued); err < 0) {
+				throw std::system_error(-err, std::generic_category(), "io_uring_submit_and_wait");
+			}
+			for (unsigned i = 0; i != queued; ++i) {
+				io_uring_cqe* cqe;
+				if (int const err = io_uring_wait_cqe(&uring, &cqe); err < 0) {
+					throw std::system_error(-err, std::generic_category(), "io_uring_wait_cqe");
+				}
+				results[reinterpret_cast<std::uintptr_t>(io_uring_cqe_get_data(cqe))] = cqe->res;
+				io_uring_cqe_seen(&uring, cqe);
+			}
+			queued = 0;
+			return results;
+		}
+
+	private:
+		io_uring uring;
+		std::vector<std::array<iovec, 2>> iovecs;
+		unsigned queued {0};
+	};
+
+#endif
+
+}//!namespace containers
@@ -0,0 +1,324 @@
+#pragma once
+
+#include "spsc_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace containers {
+
+	enum class DrainOrder {
+		RoundRobin,
+		Sequenced
+	};
+
+	/**
+	 * Many producers, one consumer, no shared hot cache line:
+	 * every producer thread owns its SPSC ring, the consumer drains them all.
+	 * A producer claims a ring on its first push and gives it back when the
+	 * thread exits, so any number of short-lived threads can come and go as long
+	 * as at most MaxProducers of them push at the same time. Claiming is the
+	 * only write to a location shared by producers.
+	 * With DrainOrder::Sequenced every element is stamped with steady_clock
+	 * and drain() merges the rings by stamp, so the output is ordered among
+	 * the elements visible at drain time.
+	 * */
+	template <typename T, std::size_t N, std::size_t MaxProducers, DrainOrder Order = DrainOrder::RoundRobin>
+	requires (MaxProducers > 0)
+	class MpscCollector {
+	private:
+		struct Stamped {
+			std::uint64_t stamp;
+			T value;
+		};
+		using entry_type = std::conditional_t<Order == DrainOrder::Sequenced, Stamped, T>;
+		using ring_type = SpscRing<entry_type, N>;
+
+		/**
+		 * Outlives the collector while a thread that has pushed to it is exiting,
+		 * so the thread can still hand its ring back.
+		 * */
+		struct Shared {
+			std::unique_ptr<ring_type[]> rings {std::make_unique<ring_type[]>(MaxProducers)};
+			std::unique_ptr<std::atomic<bool>[]> claimed {std::make_unique<std::atomic<bool>[]>(MaxProducers)};
+			//rings [0, used) have ever been claimed, the consumer looks at those only
+			alignas(64) std::atomic<std::size_t> used {0};
+
+			std::size_t claim() noexcept {
+				for (std::size_t i = 0; i != MaxProducers; ++i) {
+					bool expected {false};
+					if (not claimed[i].load(std::memory_order_relaxed)
+						&& claimed[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+						std::size_t seen = used.load(std::memory_order_relaxed);
+						while (seen <= i && not used.compare_exchange_weak(seen, i + 1, std::memory_order_release)) {}
+						return i;
+					}
+				}
+				return MaxProducers;
+			}
+
+			/**
+			 * Elements left in the ring are still drained, the next owner appends to them.
+			 * */
+			void release(std::size_t idx) noexcept {
+				claimed[idx].store(false, std::memory_order_release);
+			}
+		};
+
+	public:
+		using value_type = T;
+
+		/**
+		 * Owns a ring until destroyed, must not outlive its collector.
+		 * */
+		class Producer {
+		public:
+			Producer (Producer&& other) noexcept
+					: shared {std::exchange(other.shared, nullptr)}
+					, idx    {other.idx}
+					, ring   {other.ring}
+			{}
+
+			Producer& operator=(Producer&& other) noexcept {
+				if (this != &other) {
+					reset();
+					shared = std::exchange(other.shared, nullptr);
+					idx = other.idx;
+					ring = other.ring;
+				}
+				return *this;
+			}
+
+			~Producer() {
+				reset();
+			}
+
+			bool try_push(T value) {
+				if constexpr (Order == DrainOrder::Sequenced) {
+					return ring->try_push(Stamped{now(), std::move(value)});
+				}
+				else {
+					return ring->try_push(std::move(value));
+				}
+			}
+
+			/**
+			 * Yields while the ring is full. The ring moves from its argument
+			 * only once there is room, so the value is moved, never copied.
+			 * */
+			void push(T value) {
+				if constexpr (Order == DrainOrder::Sequenced) {
+					Stamped entry {now(), std::move(value)};
+					while (not ring->try_push(std::move(entry))) {
+						std::this_thread::yield();
+					}
+				}
+				else {
+					while (not ring->try_push(std::move(value))) {
+						std::this_thread::yield();
+					}
+				}
+			}
+
+		private:
+			friend class MpscCollector;
+
+			Shared* shared;
+			std::size_t idx;
+			ring_type* ring;
+
+			Producer (Shared* shared, std::size_t idx) noexcept
+					: shared {shared}
+					, idx    {idx}
+					, ring   {&shared->rings[idx]}
+			{}
+
+			void reset() noexcept {
+				if (shared) {
+					shared->release(idx);
+					shared = nullptr;
+				}
+			}
+
+			void detach() noexcept {
+				shared = nullptr;
+			}
+		};
+
+		MpscCollector ()
+				: shared {std::make_shared<Shared>()}
+		{}
+
+		MpscCollector (MpscCollector const&) = delete;
+		MpscCollector& operator=(MpscCollector const&) = delete;
+
+		/**
+		 * Hands out a free ring, throws std::length_error if MaxProducers are live.
+		 * */
+		Producer register_producer() {
+			std::size_t const idx = shared->claim();
+			if (idx == MaxProducers) {
+				throw std::length_error("MpscCollector can't register more than "
+										+ std::to_string(MaxProducers) + " producers");
+			}
+			return Producer(shared.get(), idx);
+		}
+
+		/**
+		 * Pushes through the calling thread's producer, registering it on first use.
+		 * */
+		bool try_push(T value) {
+			return local_producer().try_push(std::move(value));
+		}
+
+		void push(T value) {
+			local_producer().push(std::move(value));
+		}
+
+		/**
+		 * Consumer side: hands up to max_batch elements of every ring to f,
+		 * returns the number of elements drained.
+		 * */
+		template <typename F>
+		std::size_t drain(F&& f, std::size_t max_batch = N) {
+			std::size_t const producers = shared->used.load(std::memory_order_acquire);
+			if constexpr (Order == DrainOrder::Sequenced) {
+				return drain_merged(f, producers, max_batch * producers);
+			}
+			else {
+				std::size_t total {0};
+				for (std::size_t i = 0; i != producers; ++i) {
+					ring_type& ring = shared->rings[(cursor + i) % producers];
+					total += ring.consume(f, max_batch);
+				}
+				cursor = producers == 0u ? 0u : (cursor + 1) % producers;
+				return total;
+			}
+		}
+
+		/**
+		 * Producers holding a ring right now.
+		 * */
+		std::size_t producers_count() const noexcept {
+			std::size_t count {0};
+			for (std::size_t i = 0; i != MaxProducers; ++i) {
+				count += shared->claimed[i].load(std::memory_order_acquire);
+			}
+			return count;
+		}
+
+	private:
+		std::shared_ptr<Shared> shared;
+		alignas(64) std::size_t cursor {0};
+
+		/**
+		 * A thread's producer for one collector: gives the ring back when
+		 * the thread exits, or does nothing if the collector is gone by then.
+		 * */
+		struct Registration {
+			Shared* key;
+			std::weak_ptr<Shared> owner;
+			Producer producer;
+
+			Registration (std::shared_ptr<Shared> const& shared, Producer producer) noexcept
+					: key      {shared.get()}
+					, owner    {shared}
+					, producer {std::move(producer)}
+			{}
+
+			Registration (Registration&&) noexcept = default;
+
+			Registration& operator=(Registration&& other) noexcept {
+				if (this != &other) {
+					let_go();
+					key = other.key;
+					owner = std::move(other.owner);
+					producer.shared = std::exchange(other.producer.shared, nullptr);
+					producer.idx = other.producer.idx;
+					producer.ring = other.producer.ring;
+				}
+				return *this;
+			}
+
+			~Registration() {
+				let_go();
+			}
+
+			void let_go() noexcept {
+				if (auto alive = owner.lock()) {
+					producer.reset();
+				}
+				else {
+					producer.detach();
+				}
+			}
+		};
+
+		static std::uint64_t now() noexcept {
+			return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+		}
+
+		/**
+		 * Registrations of collectors that are gone are dropped as soon as one is met,
+		 * so a lookup only walks collectors alive on this thread. A dead collector's
+		 * address may be reused by a new one, its registration is dropped before matching.
+		 * */
+		Producer& local_producer() {
+			thread_local std::vector<Registration> registrations;
+			bool stale {false};
+			for (auto& registration : registrations) {
+				if (registration.owner.expired()) {
+					stale = true;
+				}
+				else if (registration.key == shared.get() && not stale) {
+					return registration.producer;
+				}
+			}
+			if (stale) {
+				std::erase_if(registrations, [](Registration const& registration) {
+					return registration.owner.expired();
+				});
+				for (auto& registration : registrations) {
+					if (registration.key == shared.get()) {
+						return registration.producer;
+					}
+				}
+			}
+			registrations.emplace_back(shared, register_producer());
+			return registrations.back().producer;
+		}
+
+		template <typename F>
+		std::size_t drain_merged(F& f, std::size_t producers, std::size_t max_count) {
+			std::size_t total {0};
+			for (; total != max_count; ++total) {
+				ring_type* oldest {nullptr};
+				std::uint64_t oldest_stamp {std::numeric_limits<std::uint64_t>::max()};
+				for (std::size_t i = 0; i != producers; ++i) {
+					if (Stamped* entry = shared->rings[i].peek(); entry && entry->stamp < oldest_stamp) {
+						oldest_stamp = entry->stamp;
+						oldest = &shared->rings[i];
+					}
+				}
+				if (not oldest) {
+					break;
+				}
+				f(std::move(oldest->peek()->value));
+				oldest->pop();
+			}
+			return total;
+		}
+	};
+
+}//!namespace containers
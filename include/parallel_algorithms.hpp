@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace containers {
+
+	namespace details {
+
+		/**
+		 * Below this many elements per thread a chunk isn't worth a thread.
+		 * */
+		inline constexpr std::size_t parallel_min_chunk {std::size_t{1} << 14};
+
+		template <typename Buffer>
+		concept segmented_window = requires (Buffer& b) {
+			b.array_one();
+			b.array_two();
+			{ b.size() } -> std::convertible_to<std::size_t>;
+		};
+
+		inline std::size_t parallel_chunks(std::size_t size, std::size_t threads) noexcept {
+			if (threads == 0u) {
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			}
+			return std::clamp<std::size_t>(size / parallel_min_chunk, 1u, threads);
+		}
+
+		/**
+		 * Splits [0, size) into chunks consecutive ranges and calls f(chunk, begin, end)
+		 * for each, the calling thread takes the first one. The first exception
+		 * thrown by any chunk is rethrown once all of them are done.
+		 * */
+		template <typename F>
+		void run_chunks(std::size_t size, std::size_t chunks, F const& f) {
+			std::vector<std::exception_ptr> errors (chunks);
+			auto run = [&](std::size_t c) {
+				try {
+					f(c, c * size / chunks, (c + 1) * size / chunks);
+				}
+				catch (...) {
+					errors[c] = std::current_exception();
+				}
+			};
+			{
+				std::vector<std::jthread> workers;
+				workers.reserve(chunks - 1);
+				for (std::size_t c = 1; c < chunks; ++c) {
+					workers.emplace_back(run, c);
+				}
+				run(0);
+			}
+			for (auto& error : errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+		}
+
+		/**
+		 * Calls f on the one or two contiguous pieces that hold logical elements [begin, end).
+		 * */
+		template <typename Span, typename F>
+		void for_pieces(Span one, Span two, std::size_t begin, std::size_t end, F&& f) {
+			if (begin < one.size()) {
+				f(one.subspan(begin, std::min(end, one.size()) - begin));
+			}
+			if (end > one.size()) {
+				std::size_t const from = std::max(begin, one.size()) - one.size();
+				f(two.subspan(from, end - one.size() - from));
+			}
+		}
+
+	}//!namespace details
+
+	/**
+	 * Algorithms over the window of a buffer that exposes it as array_one()/array_two(),
+	 * split into chunks of consecutive elements run on std::jthread.
+	 * threads == 0 means hardware_concurrency(), small windows run on the calling thread.
+	 * */
+	namespace parallel {
+
+		/**
+		 * No order among chunks, f must be safe to call concurrently on distinct elements.
+		 * */
+		template <typename Buffer, typename F>
+		requires details::segmented_window<Buffer>
+		void for_each(Buffer& buffer, F f, std::size_t threads = 0) {
+			auto const one = buffer.array_one();
+			auto const two = buffer.array_two();
+			std::size_t const size = buffer.size();
+			details::run_chunks(size, details::parallel_chunks(size, threads), [&](std::size_t, std::size_t begin, std::size_t end) {
+				details::for_pieces(one, two, begin, end, [&](auto piece) {
+					std::for_each(piece.begin(), piece.end(), f);
+				});
+			});
+		}
+
+		/**
+		 * Chunk results are combined oldest to newest, so reduce has to be
+		 * associative but not commutative.
+		 * */
+		template <typename Buffer, typename R, typename Reduce, typename Transform>
+		requires details::segmented_window<Buffer>
+		R transform_reduce(Buffer const& buffer, R init, Reduce reduce, Transform transform, std::size_t threads = 0) {
+			auto const one = buffer.array_one();
+			auto const two = buffer.array_two();
+			std::size_t const size = buffer.size();
+			if (size == 0u) {
+				return init;
+			}
+			std::size_t const chunks = details::parallel_chunks(size, threads);
+			std::vector<R> partials (chunks, init);
+			details::run_chunks(size, chunks, [&](std::size_t c, std::size_t begin, std::size_t end) {
+				R& partial = partials[c];
+				bool first {true};
+				details::for_pieces(one, two, begin, end, [&](auto piece) {
+					for (auto const& value : piece) {
+						partial = first ? R(transform(value)) : reduce(std::move(partial), transform(value));
+						first = false;
+					}
+				});
+			});
+			for (auto& partial : partials) {
+				init = reduce(std::move(init), std::move(partial));
+			}
+			return init;
+		}
+
+		/**
+		 * Copies the window to out oldest to newest, returns the number of elements copied.
+		 * */
+		template <typename Buffer, std::random_access_iterator Out>
+		requires details::segmented_window<Buffer>
+		std::size_t copy_to(Buffer const& buffer, Out out, std::size_t threads = 0) {
+			auto const one = buffer.array_one();
+			auto const two = buffer.array_two();
+			std::size_t const size = buffer.size();
+			details::run_chunks(size, details::parallel_chunks(size, threads), [&](std::size_t, std::size_t begin, std::size_t end) {
+				auto to = out + static_cast<std::iter_difference_t<Out>>(begin);
+				details::for_pieces(one, two, begin, end, [&](auto piece) {
+					to = std::copy(piece.begin(), piece.end(), to);
+				});
+			});
+			return size;
+		}
+
+		/**
+		 * Sorted copy of the window: chunks are copied and sorted in parallel,
+		 * then merged pairwise, every round of merges in parallel too.
+		 * Returns the number of elements copied.
+		 * */
+		template <typename Buffer, std::random_access_iterator Out, typename Compare = std::less<>>
+		requires details::segmented_window<Buffer>
+		std::size_t sort_copy(Buffer const& buffer, Out out, Compare comp = {}, std::size_t threads = 0) {
+			auto const one = buffer.array_one();
+			auto const two = buffer.array_two();
+			std::size_t const size = buffer.size();
+			std::size_t const chunks = details::parallel_chunks(size, threads);
+			auto at = [out](std::size_t idx) {
+				return out + static_cast<std::iter_difference_t<Out>>(idx);
+			};
+			details::run_chunks(size, chunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+				auto to = at(begin);
+				details::for_pieces(one, two, begin, end, [&](auto piece) {
+					to = std::copy(piece.begin(), piece.end(), to);
+				});
+				std::sort(at(begin), at(end), comp);
+			});
+			auto bound = [&](std::size_t c) {
+				return std::min(c, chunks) * size / chunks;
+			};
+			for (std::size_t width = 1; width < chunks; width *= 2) {
+				std::size_t const pairs = (chunks + 2 * width - 1) / (2 * width);
+				details::run_chunks(pairs, pairs, [&](std::size_t p, std::size_t, std::size_t) {
+					std::size_t const first = p * 2 * width;
+					std::inplace_merge(at(bound(first)), at(bound(first + width)), at(bound(first + 2 * width)), comp);
+				});
+			}
+			return size;
+		}
+
+	}//!namespace parallel
+
+}//!namespace containers
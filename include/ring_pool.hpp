@@ -0,0 +1,272 @@
+#pragma once
+
+#include "circular_buffer_fixed.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace containers {
+
+	/**
+	 * Many small keyed rings of the same capacity N.
+	 * All the ring storage is one slab allocated in ctor, metadata is packed
+	 * into the smallest index type that fits N, keys are mapped to ring
+	 * handles by a linear probing table. Rings are created and recycled
+	 * without touching the heap.
+	 * */
+	template <typename T, std::size_t N, typename Key, typename Hash = std::hash<Key>>
+	requires (N > 0) && std::is_default_constructible_v<T> && std::equality_comparable<Key>
+	class RingPool {
+	public:
+		using value_type = T;
+		using key_type = Key;
+		using index_type = details::index_type_for_t<N>;
+		using handle_type = std::uint32_t;
+
+		static constexpr handle_type npos {std::numeric_limits<handle_type>::max()};
+
+	private:
+		struct Meta {
+			index_type front_idx;
+			index_type sz;
+		};
+
+		struct Slot {
+			Key key;
+			handle_type handle {npos};
+		};
+
+	public:
+		/**
+		 * Non-owning view of one ring of the pool, same semantics as CircularBufferFixed:
+		 * push_back on a full ring overwrites the oldest element.
+		 * */
+		class Ring {
+		public:
+			Ring (T* data, Meta* meta) noexcept
+					: data {data}
+					, meta {meta}
+			{}
+
+			void push_back(T t) noexcept {
+				if (meta->sz < N) [[likely]] {
+					data[get_idx(meta->sz)] = std::move(t);
+					++meta->sz;
+				}
+				else {
+					data[meta->front_idx] = std::move(t);
+					meta->front_idx = static_cast<index_type>(get_idx(1));
+				}
+			}
+
+			T& pop_front() noexcept {
+				T& res = data[meta->front_idx];
+				if (meta->sz > 0) [[likely]] {
+					meta->front_idx = static_cast<index_type>(get_idx(1));
+					--meta->sz;
+				}
+				return res;
+			}
+
+			T& front() noexcept {
+				return data[meta->front_idx];
+			}
+
+			T& back() noexcept {
+				return data[get_idx(meta->sz == 0u ? 0u : meta->sz - 1u)];
+			}
+
+			T& operator[](std::size_t idx) noexcept {
+				return data[get_idx(idx)];
+			}
+
+			T& at(std::size_t idx) {
+				if (idx >= meta->sz) {
+					throw std::out_of_range("RingPool::Ring is out of range with idx " + std::to_string(idx));
+				}
+				return data[get_idx(idx)];
+			}
+
+			static constexpr std::size_t capacity() noexcept {
+				return N;
+			}
+
+			std::size_t size() const noexcept {
+				return meta->sz;
+			}
+
+			bool empty() const noexcept {
+				return meta->sz == 0u;
+			}
+
+		private:
+			T* data;
+			Meta* meta;
+
+			std::size_t get_idx (std::size_t idx) const noexcept {
+				idx += meta->front_idx;
+				return idx < N ? idx : idx - N;
+			}
+		};
+
+		explicit RingPool (std::size_t max_rings)
+				: rings_count {0}
+				, max_rings_count {checked_max_rings(max_rings)}
+				, free_head {max_rings == 0u ? npos : 0u}
+				, table_mask {std::bit_ceil(std::max<std::size_t>(max_rings * 2u, 2u)) - 1u}
+				, table_shift {64 - std::countr_zero(static_cast<std::uint64_t>(table_mask) + 1u)}
+				, slab {std::make_unique<T[]>(max_rings * N)}
+				, meta {std::make_unique<Meta[]>(max_rings)}
+				, next_free {std::make_unique<handle_type[]>(max_rings)}
+				, table {std::make_unique<Slot[]>(table_mask + 1u)}
+		{
+			for (std::size_t i = 0; i != max_rings; ++i) {
+				next_free[i] = i + 1u == max_rings ? npos : static_cast<handle_type>(i + 1u);
+			}
+		}
+
+		/**
+		 * Returns npos if there is no ring for the key.
+		 * */
+		handle_type find(Key const& key) const noexcept {
+			for (std::size_t i = home(key); ; i = (i + 1u) & table_mask) {
+				if (table[i].handle == npos) {
+					return npos;
+				}
+				if (table[i].key == key) {
+					return table[i].handle;
+				}
+			}
+		}
+
+		/**
+		 * Returns the ring handle of the key, creating an empty ring if needed.
+		 * Throws std::length_error if all the rings are taken.
+		 * */
+		handle_type acquire(Key const& key) {
+			std::size_t i = home(key);
+			for (; table[i].handle != npos; i = (i + 1u) & table_mask) {
+				if (table[i].key == key) {
+					return table[i].handle;
+				}
+			}
+			if (free_head == npos) [[unlikely]] {
+				throw std::length_error("RingPool is exhausted, max rings is " + std::to_string(max_rings_count));
+			}
+			handle_type const handle = free_head;
+			free_head = next_free[handle];
+			meta[handle] = Meta{0, 0};
+			table[i].key = key;
+			table[i].handle = handle;
+			++rings_count;
+			return handle;
+		}
+
+		/**
+		 * Recycles the ring of the key, returns false if there is none.
+		 * */
+		bool release(Key const& key) noexcept {
+			std::size_t i = home(key);
+			for (; table[i].handle != npos; i = (i + 1u) & table_mask) {
+				if (table[i].key == key) {
+					next_free[table[i].handle] = free_head;
+					free_head = table[i].handle;
+					--rings_count;
+					erase_slot(i);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		Ring ring(handle_type handle) noexcept {
+			return Ring(slab.get() + static_cast<std::size_t>(handle) * N, meta.get() + handle);
+		}
+
+		Ring ring(Key const& key) {
+			return ring(acquire(key));
+		}
+
+		static constexpr std::size_t ring_capacity() noexcept {
+			return N;
+		}
+
+		std::size_t max_rings() const noexcept {
+			return max_rings_count;
+		}
+
+		std::size_t size() const noexcept {
+			return rings_count;
+		}
+
+		bool empty() const noexcept {
+			return rings_count == 0u;
+		}
+
+	private:
+		std::size_t rings_count;
+		std::size_t max_rings_count;
+		handle_type free_head;
+		std::size_t table_mask;
+		int table_shift;
+		[[no_unique_address]] Hash hasher;
+
+		std::unique_ptr<T[]> slab;
+		std::unique_ptr<Meta[]> meta;
+		std::unique_ptr<handle_type[]> next_free;
+		std::unique_ptr<Slot[]> table;
+
+		/**
+		 * Runs in the initializer of max_rings_count, before anything is allocated.
+		 * */
+		static std::size_t checked_max_rings(std::size_t max_rings) {
+			if (max_rings >= npos || max_rings > std::numeric_limits<std::size_t>::max() / (2u * N)) {
+				throw std::length_error("RingPool can't hold " + std::to_string(max_rings) + " rings");
+			}
+			return max_rings;
+		}
+
+		/**
+		 * Fibonacci hashing: std::hash of an integer is the identity in libstdc++,
+		 * so the hash is mixed and its high bits are taken, strided keys don't
+		 * collapse onto one probe chain.
+		 * */
+		std::size_t home (Key const& key) const noexcept {
+			std::uint64_t const mixed = static_cast<std::uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;
+			return static_cast<std::size_t>(mixed >> table_shift) & table_mask;
+		}
+
+		/**
+		 * Backward shift deletion: no tombstones, probe sequences stay short.
+		 * */
+		void erase_slot (std::size_t i) noexcept {
+			for (;;) {
+				table[i].handle = npos;
+				std::size_t j = i;
+				for (;;) {
+					j = (j + 1u) & table_mask;
+					if (table[j].handle == npos) {
+						return;
+					}
+					std::size_t const k = home(table[j].key);
+					bool const stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+					if (not stays) {
+						break;
+					}
+				}
+				table[i] = std::move(table[j]);
+				i = j;
+			}
+		}
+	};
+
+}//!namespace containers
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "circular_buffer_bank.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace containers {
+
+	/**
+	 * Rolling covariance and correlation of K synchronized series over the last N steps.
+	 * Keeps the mean of every series and the mean-centred co-moment of every pair,
+	 * a step replaces the row leaving the window with the incoming one by a Welford-style
+	 * update: O(K^2) per step instead of O(K^2 * N), and no cancellation of large raw
+	 * sums, so float series with a large mean and a small spread stay accurate.
+	 * The co-moments are a K x stride matrix whose rows are updated by contiguous,
+	 * padded, branch-free loops the compiler turns into SIMD.
+	 * Rounding of the sliding updates is bounded by a shadow accumulator that adds
+	 * every incoming row from scratch and takes over each N steps, when it holds
+	 * exactly the window: the cost is a second update per step, never a recomputation.
+	 * */
+	template <std::floating_point T, std::size_t N, std::size_t K>
+	requires (N > 1 && K > 0)
+	class RollingCovariance {
+	public:
+		using value_type = T;
+		using window_type = CircularBufferBank<T, N, K>;
+
+		static constexpr std::size_t stride {window_type::stride};
+
+		RollingCovariance () {
+			moments[0].reset();
+			moments[1].reset();
+		}
+
+		void push(std::span<T const, K> row) noexcept {
+			alignas(details::cache_line_size) std::array<T, stride> in {};
+			alignas(details::cache_line_size) std::array<T, stride> out {};
+			std::copy(row.begin(), row.end(), in.begin());
+			bool const full = window.size() == N;
+			if (full) {
+				auto const leaving = window.front_row();
+				std::copy(leaving.begin(), leaving.end(), out.begin());
+			}
+			window.push_row(row);
+
+			if (full) {
+				moments[active].replace(in, out);
+			}
+			else {
+				moments[active].add(in);
+			}
+			moments[active ^ 1u].add(in);
+			if (++steps_since_swap == N) {
+				active ^= 1u;
+				moments[active ^ 1u].reset();
+				steps_since_swap = 0;
+			}
+		}
+
+		std::size_t size() const noexcept {
+			return window.size();
+		}
+
+		window_type const& series() const noexcept {
+			return window;
+		}
+
+		T mean(std::size_t i) const noexcept {
+			return moments[active].mean[i];
+		}
+
+		/**
+		 * Sample covariance, NaN with less than two steps in the window.
+		 * */
+		T covariance(std::size_t i, std::size_t j) const noexcept {
+			Moments const& m = moments[active];
+			if (m.count < 2u) {
+				return std::numeric_limits<T>::quiet_NaN();
+			}
+			return m.comoment[i * stride + j] / static_cast<T>(m.count - 1);
+		}
+
+		/**
+		 * NaN if either series is constant over the window.
+		 * */
+		T correlation(std::size_t i, std::size_t j) const noexcept {
+			T const denominator = std::sqrt(covariance(i, i) * covariance(j, j));
+			if (not (denominator > 0)) {
+				return std::numeric_limits<T>::quiet_NaN();
+			}
+			return std::clamp<T>(covariance(i, j) / denominator, -1, 1);
+		}
+
+		/**
+		 * Row-major K x K matrices.
+		 * */
+		void covariance(std::span<T, K * K> out) const noexcept {
+			for (std::size_t i = 0; i != K; ++i) {
+				for (std::size_t j = 0; j != K; ++j) {
+					out[i * K + j] = covariance(i, j);
+				}
+			}
+		}
+
+		void correlation(std::span<T, K * K> out) const noexcept {
+			for (std::size_t i = 0; i != K; ++i) {
+				for (std::size_t j = 0; j != K; ++j) {
+					out[i * K + j] = i == j ? T{1} : correlation(i, j);
+				}
+			}
+		}
+
+	private:
+		using row_type = std::array<T, stride>;
+
+		/**
+		 * Means and co-moments sum((x_i - mean_i) * (x_j - mean_j)) of count rows.
+		 * Padding lanes stay zero.
+		 * */
+		struct Moments {
+			alignas(details::cache_line_size) row_type mean;
+			alignas(details::cache_line_size) std::array<T, K * stride> comoment;
+			std::size_t count;
+
+			void reset() noexcept {
+				mean.fill(T{});
+				comoment.fill(T{});
+				count = 0;
+			}
+
+			/**
+			 * C += (x - old mean) (x - new mean)
+			 * */
+			void add(row_type const& x) noexcept {
+				alignas(details::cache_line_size) row_type before;
+				alignas(details::cache_line_size) row_type after;
+				++count;
+				T const inv = T{1} / static_cast<T>(count);
+				for (std::size_t j = 0; j != stride; ++j) {
+					before[j] = x[j] - mean[j];
+					mean[j] += before[j] * inv;
+					after[j] = x[j] - mean[j];
+				}
+				for (std::size_t i = 0; i != K; ++i) {
+					T const before_i = before[i];
+					T* row = comoment.data() + i * stride;
+					for (std::size_t j = 0; j != stride; ++j) {
+						row[j] += before_i * after[j];
+					}
+				}
+			}
+
+			/**
+			 * Count stays: C += (x - old mean) (x - new mean) - (y - old mean) (y - new mean)
+			 * */
+			void replace(row_type const& x, row_type const& y) noexcept {
+				alignas(details::cache_line_size) row_type in_before;
+				alignas(details::cache_line_size) row_type in_after;
+				alignas(details::cache_line_size) row_type out_before;
+				alignas(details::cache_line_size) row_type out_after;
+				T const inv = T{1} / static_cast<T>(count);
+				for (std::size_t j = 0; j != stride; ++j) {
+					in_before[j] = x[j] - mean[j];
+					out_before[j] = y[j] - mean[j];
+					mean[j] += (x[j] - y[j]) * inv;
+					in_after[j] = x[j] - mean[j];
+					out_after[j] = y[j] - mean[j];
+				}
+				for (std::size_t i = 0; i != K; ++i) {
+					T const in_i = in_before[i];
+					T const out_i = out_before[i];
+					T* row = comoment.data() + i * stride;
+					for (std::size_t j = 0; j != stride; ++j) {
+						row[j] += in_i * in_after[j] - out_i * out_after[j];
+					}
+				}
+			}
+		};
+
+		window_type window;
+		std::array<Moments, 2> moments;
+		std::size_t active {0};
+		std::size_t steps_since_swap {0};
+	};
+
+}//!namespace containers
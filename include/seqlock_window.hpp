@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+namespace containers {
+
+	/**
+	 * Single-writer/multi-reader window guarded by a sequence counter.
+	 * The writer never blocks and never waits for readers: every modification
+	 * makes the counter odd, changes the window and makes it even again.
+	 * A reader copies the window out and retries if the counter has moved.
+	 * Elements are stored as machine words, written and read with relaxed
+	 * std::atomic_ref, so a copy racing with the writer is torn but never
+	 * a data race, hence trivially copyable T only; a torn copy is detected
+	 * and thrown away.
+	 * */
+	template <typename T, std::size_t N>
+	requires (N > 0) && std::is_trivially_copyable_v<T>
+	class SeqlockWindow {
+	public:
+		using value_type = T;
+
+		//-------------------------
+		// writer side, one thread only
+
+		void push_back(T const& t) noexcept {
+			std::size_t const f = front_idx.load(std::memory_order_relaxed);
+			std::size_t const s = sz.load(std::memory_order_relaxed);
+			begin_write();
+			if (s < N) [[likely]] {
+				store(wrap(f + s), t);
+				sz.store(s + 1, std::memory_order_relaxed);
+			}
+			else {
+				store(f, t);
+				front_idx.store(wrap(f + 1), std::memory_order_relaxed);
+			}
+			end_write();
+		}
+
+		void pop_front() noexcept {
+			std::size_t const s = sz.load(std::memory_order_relaxed);
+			if (s == 0u) [[unlikely]] {
+				return;
+			}
+			begin_write();
+			front_idx.store(wrap(front_idx.load(std::memory_order_relaxed) + 1), std::memory_order_relaxed);
+			sz.store(s - 1, std::memory_order_relaxed);
+			end_write();
+		}
+
+		void clear() noexcept {
+			begin_write();
+			front_idx.store(0u, std::memory_order_relaxed);
+			sz.store(0u, std::memory_order_relaxed);
+			end_write();
+		}
+
+		//-------------------------
+		// reader side, any thread
+
+		/**
+		 * One attempt to copy the newest min(size, out.size()) elements,
+		 * oldest to newest. Returns the number copied, nullopt if the
+		 * writer interfered and the copy has to be retried.
+		 * */
+		std::optional<std::size_t> try_snapshot(std::span<T> out) const noexcept {
+			std::uint64_t const before = seq.load(std::memory_order_acquire);
+			if (before & 1u) {
+				return std::nullopt;
+			}
+			//indices may be torn together with the data, keep the copy in bounds anyway
+			std::size_t const f = std::min(front_idx.load(std::memory_order_relaxed), N - 1);
+			std::size_t const s = std::min(sz.load(std::memory_order_relaxed), N);
+			std::size_t const count = std::min(s, out.size());
+			std::size_t const first = wrap(f + (s - count));
+			std::size_t const one = std::min(count, N - first);
+			for (std::size_t i = 0; i != one; ++i) {
+				load(first + i, out[i]);
+			}
+			for (std::size_t i = one; i != count; ++i) {
+				load(i - one, out[i]);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (seq.load(std::memory_order_relaxed) != before) {
+				return std::nullopt;
+			}
+			return count;
+		}
+
+		/**
+		 * Retries until a consistent copy is made.
+		 * */
+		std::size_t snapshot_into(std::span<T> out) const noexcept {
+			for (;;) {
+				if (auto count = try_snapshot(out)) {
+					return *count;
+				}
+			}
+		}
+
+		/**
+		 * Approximate when called concurrently with the writer.
+		 * */
+		std::size_t size() const noexcept {
+			return sz.load(std::memory_order_relaxed);
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+	private:
+		alignas(64) std::atomic<std::uint64_t> seq {0};
+		std::atomic<std::size_t> front_idx {0};
+		std::atomic<std::size_t> sz {0};
+		using word = std::uintptr_t;
+		static constexpr std::size_t words {(sizeof(T) + sizeof(word) - 1) / sizeof(word)};
+
+		//mutable for readers: std::atomic_ref<T const> is C++26
+		alignas(64) mutable std::array<word, N * words> data {};
+
+		static constexpr std::size_t wrap (std::size_t idx) noexcept {
+			return idx < N ? idx : idx - N;
+		}
+
+		void store(std::size_t idx, T const& t) noexcept {
+			std::array<word, words> w {};
+			std::memcpy(w.data(), &t, sizeof(T));
+			for (std::size_t i = 0; i != words; ++i) {
+				std::atomic_ref<word>(data[idx * words + i]).store(w[i], std::memory_order_relaxed);
+			}
+		}
+
+		void load(std::size_t idx, T& t) const noexcept {
+			std::array<word, words> w;
+			for (std::size_t i = 0; i != words; ++i) {
+				w[i] = std::atomic_ref<word>(data[idx * words + i]).load(std::memory_order_relaxed);
+			}
+			std::memcpy(&t, w.data(), sizeof(T));
+		}
+
+		void begin_write() noexcept {
+			seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+
+		void end_write() noexcept {
+			seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+	};
+
+}//!namespace containers
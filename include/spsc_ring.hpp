@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace containers {
+
+	/**
+	 * Wait-free single-producer/single-consumer ring.
+	 * Head and tail are free-running counters on separate cache lines,
+	 * each side keeps a private copy of the other side's counter and reloads
+	 * it only when the ring looks full (producer) or empty (consumer).
+	 * */
+	template <typename T, std::size_t N>
+	requires (N > 0) && std::is_default_constructible_v<T>
+	class SpscRing {
+	public:
+		using value_type = T;
+
+		//-------------------------
+		// producer side
+
+		template <typename U>
+		bool try_push(U&& value) {
+			std::size_t const t = tail.load(std::memory_order_relaxed);
+			if (t - cached_head == N) {
+				cached_head = head.load(std::memory_order_acquire);
+				if (t - cached_head == N) {
+					return false;
+				}
+			}
+			data[t % N] = std::forward<U>(value);
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		//-------------------------
+		// consumer side
+
+		/**
+		 * Front element or nullptr if the ring is empty.
+		 * */
+		T* peek() noexcept {
+			std::size_t const h = head.load(std::memory_order_relaxed);
+			if (h == cached_tail) {
+				cached_tail = tail.load(std::memory_order_acquire);
+				if (h == cached_tail) {
+					return nullptr;
+				}
+			}
+			return &data[h % N];
+		}
+
+		/**
+		 * Drops the front element, must follow a successful peek().
+		 * */
+		void pop() noexcept {
+			head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Hands up to max_count elements to f, publishes the new head once per batch.
+		 * */
+		template <typename F>
+		std::size_t consume(F&& f, std::size_t max_count = N) {
+			std::size_t const h = head.load(std::memory_order_relaxed);
+			//one acquire load per batch, so the batch takes everything published so far
+			cached_tail = tail.load(std::memory_order_acquire);
+			std::size_t const count = std::min(cached_tail - h, max_count);
+			for (std::size_t i = 0; i != count; ++i) {
+				f(std::move(data[(h + i) % N]));
+			}
+			if (count != 0u) {
+				head.store(h + count, std::memory_order_release);
+			}
+			return count;
+		}
+
+		/**
+		 * Approximate when called concurrently with either side.
+		 * */
+		std::size_t size() const noexcept {
+			return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+		}
+
+		static constexpr std::size_t capacity() noexcept {
+			return N;
+		}
+
+	private:
+		static constexpr std::size_t cache_line {64};
+
+		alignas(cache_line) std::atomic<std::size_t> tail {0};
+		std::size_t cached_head {0};
+
+		alignas(cache_line) std::atomic<std::size_t> head {0};
+		std::size_t cached_tail {0};
+
+		alignas(cache_line) std::array<T, N> data {};
+	};
+
+}//!namespace containers
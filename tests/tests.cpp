@@ -1,8 +1,27 @@
 #include <gtest/gtest.h>
 #include "../include/circular_buffer_fixed.hpp"
+#include "../include/circular_buffer_cascade.hpp"
+#include "../include/circular_buffer_bank.hpp"
+#include "../include/ring_pool.hpp"
+#include "../include/blocking_queue.hpp"
+#include "../include/channel.hpp"
+#include "../include/mpsc_collector.hpp"
+#include "../include/seqlock_window.hpp"
+#include "../include/circular_buffer_io.hpp"
+#include "../include/parallel_algorithms.hpp"
+#include "../include/rolling_covariance.hpp"
 
 #include <string>
 #include <sstream>
+#include <deque>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <limits>
+
+#include <fcntl.h>
 
 using namespace containers;
 
@@ -385,6 +404,1186 @@ TEST(iterating, using_sq_brackets ) {
 	}
 }
 
+struct SumReducer {
+	using aggregate_type = int;
+	static int lift(int t) { return t; }
+	static void combine(int& acc, int next) { acc += next; }
+};
+
+TEST(cascade, rollups_sum) {
+	CircularBufferCascade<int, SumReducer, 4, CascadeLevel<3, 2>, CascadeLevel<2, 3>> cascade;
+	for (int i = 1; i != 13; ++i) {
+		cascade.push_back(i);
+	}
+	//raw {9, 10, 11, 12}, pairs {1+2, 3+4, ..., 11+12}, triples of pairs {1..6, 7..12}
+	auto const& raw = cascade.level<0>();
+	ASSERT_EQ(raw.size(), 4u);
+	ASSERT_EQ(raw.front(), 9);
+	ASSERT_EQ(raw.back(), 12);
+
+	auto const& pairs = cascade.level<1>();
+	ASSERT_EQ(pairs.size(), 3u);
+	ASSERT_EQ(pairs.at(0), 7 + 8);
+	ASSERT_EQ(pairs.at(1), 9 + 10);
+	ASSERT_EQ(pairs.at(2), 11 + 12);
+
+	auto const& sixes = cascade.level<2>();
+	ASSERT_EQ(sixes.size(), 2u);
+	ASSERT_EQ(sixes.at(0), 21);
+	ASSERT_EQ(sixes.at(1), 57);
+	ASSERT_EQ(cascade.partial_count<1>(), 0u);
+	ASSERT_EQ(cascade.partial_count<2>(), 0u);
+
+	cascade.push_back(13);
+	ASSERT_EQ(cascade.partial_count<1>(), 1u);
+	ASSERT_EQ(cascade.partial<1>(), 13);
+	ASSERT_EQ(pairs.size(), 3u);
+}
+
+TEST(cascade, rollups_ohlc) {
+	CircularBufferCascade<double, reducers::OHLC<double>, 8, CascadeLevel<4, 4>> cascade;
+	for (double v : {3., 5., 1., 2., 7., 4.}) {
+		cascade.push_back(v);
+	}
+	auto const& bars = cascade.level<1>();
+	ASSERT_EQ(bars.size(), 1u);
+	auto const& bar = bars.back();
+	ASSERT_EQ(bar.open, 3.);
+	ASSERT_EQ(bar.high, 5.);
+	ASSERT_EQ(bar.low, 1.);
+	ASSERT_EQ(bar.close, 2.);
+	ASSERT_EQ(bar.sum, 11.);
+	ASSERT_EQ(bar.count, 4);
+
+	ASSERT_EQ(cascade.partial_count<1>(), 2u);
+	ASSERT_EQ(cascade.partial<1>().open, 7.);
+	ASSERT_EQ(cascade.partial<1>().low, 4.);
+}
+
+TEST(bank, push_row_and_views) {
+	CircularBufferBank<double, 3, 4> bank;
+	ASSERT_TRUE(bank.empty());
+	ASSERT_EQ(bank.series_count(), 4u);
+	for (int t = 0; t != 5; ++t) {
+		std::array<double, 4> row {t * 10., t * 10. + 1, t * 10. + 2, t * 10. + 3};
+		bank.push_row(row);
+	}
+	//logic rows are t = {2, 3, 4}
+	ASSERT_EQ(bank.size(), 3u);
+	ASSERT_EQ(bank.front_row()[0], 20.);
+	ASSERT_EQ(bank.back_row()[3], 43.);
+	ASSERT_EQ(bank.row(1)[2], 32.);
+	ASSERT_EQ(bank.at(2, 1), 41.);
+	ASSERT_THROW(bank.at(3, 0), std::out_of_range);
+	ASSERT_THROW(bank.at(0, 4), std::out_of_range);
+
+	auto col = bank.column(1);
+	ASSERT_EQ(col.size(), 3u);
+	ASSERT_EQ(col.front(), 21.);
+	ASSERT_EQ(col[1], 31.);
+	ASSERT_EQ(col.back(), 41.);
+
+	bank.pop_front_row();
+	ASSERT_EQ(bank.size(), 2u);
+	ASSERT_EQ(bank.front_row()[0], 30.);
+	ASSERT_EQ(bank.column(3).front(), 33.);
+}
+
+TEST(bank, rows_are_cache_line_aligned) {
+	CircularBufferBank<float, 4, 3> bank;
+	bank.push_row(std::array<float, 3>{1.f, 2.f, 3.f});
+	bank.push_row(std::array<float, 3>{4.f, 5.f, 6.f});
+	auto const address = reinterpret_cast<std::uintptr_t>(bank.back_row().data());
+	ASSERT_EQ(address % 64u, 0u);
+	ASSERT_EQ(bank.back_row()[2], 6.f);
+}
+
+TEST(ring_pool, packed_metadata) {
+	static_assert(std::is_same_v<RingPool<double, 64, int>::index_type, std::uint8_t>);
+	static_assert(std::is_same_v<RingPool<double, 256, int>::index_type, std::uint16_t>);
+}
+
+TEST(ring_pool, acquire_push_release) {
+	RingPool<int, 3, std::string> pool(2);
+	ASSERT_TRUE(pool.empty());
+	ASSERT_EQ(pool.find("AAPL"), pool.npos);
+
+	auto aapl = pool.ring("AAPL");
+	for (int i = 1; i != 5; ++i) {
+		aapl.push_back(i);
+	}
+	ASSERT_EQ(aapl.size(), 3u);
+	ASSERT_EQ(aapl.front(), 2);
+	ASSERT_EQ(aapl.back(), 4);
+	ASSERT_EQ(aapl.at(1), 3);
+	ASSERT_THROW(aapl.at(3), std::out_of_range);
+	ASSERT_EQ(aapl.pop_front(), 2);
+	ASSERT_EQ(aapl.size(), 2u);
+
+	auto const msft = pool.acquire("MSFT");
+	ASSERT_NE(msft, pool.find("AAPL"));
+	ASSERT_EQ(pool.size(), 2u);
+	ASSERT_THROW(pool.acquire("GOOG"), std::length_error);
+
+	ASSERT_TRUE(pool.release("AAPL"));
+	ASSERT_FALSE(pool.release("AAPL"));
+	ASSERT_EQ(pool.find("AAPL"), pool.npos);
+	ASSERT_EQ(pool.find("MSFT"), msft);
+
+	auto goog = pool.ring("GOOG");
+	ASSERT_TRUE(goog.empty());
+	goog.push_back(42);
+	ASSERT_EQ(goog.front(), 42);
+	ASSERT_EQ(pool.ring(msft).size(), 0u);
+}
+
+struct CollidingHash {
+	std::size_t operator()(int key) const noexcept {
+		return static_cast<std::size_t>(key % 2);
+	}
+};
+
+TEST(ring_pool, release_under_collisions) {
+	RingPool<int, 4, int, CollidingHash> pool(16);
+	for (int key = 0; key != 16; ++key) {
+		pool.ring(key).push_back(key);
+	}
+	for (int key = 0; key < 16; key += 3) {
+		ASSERT_TRUE(pool.release(key));
+	}
+	for (int key = 0; key != 16; ++key) {
+		if (key % 3 == 0) {
+			ASSERT_EQ(pool.find(key), pool.npos);
+		}
+		else {
+			ASSERT_NE(pool.find(key), pool.npos);
+			ASSERT_EQ(pool.ring(pool.find(key)).front(), key);
+		}
+	}
+}
+
+TEST(ring_pool, oversized_pool_throws_before_allocating) {
+	using Pool = RingPool<int, 4, int>;
+	ASSERT_THROW(Pool pool(Pool::npos), std::length_error);
+	ASSERT_THROW(Pool pool(std::numeric_limits<std::size_t>::max()), std::length_error);
+}
+
+namespace {
+	/**
+	 * Counts key comparisons, each one is a probed occupied slot.
+	 * */
+	struct ProbedKey {
+		static inline std::size_t probes {0};
+		std::uint64_t value;
+
+		bool operator==(ProbedKey const& other) const noexcept {
+			++probes;
+			return value == other.value;
+		}
+	};
+
+	//identity, as std::hash of an integer in libstdc++
+	struct IdentityHash {
+		std::size_t operator()(ProbedKey const& key) const noexcept {
+			return static_cast<std::size_t>(key.value);
+		}
+	};
+}
+
+TEST(ring_pool, strided_keys_spread_over_table) {
+	constexpr std::uint64_t keys {50'000};
+	RingPool<int, 2, ProbedKey, IdentityHash> pool(keys);
+	for (std::uint64_t i = 0; i != keys; ++i) {
+		pool.ring(ProbedKey{i << 18}).push_back(static_cast<int>(i));
+	}
+	std::size_t longest {0};
+	ProbedKey::probes = 0;
+	for (std::uint64_t i = 0; i != keys; ++i) {
+		std::size_t const before = ProbedKey::probes;
+		ASSERT_EQ(pool.ring(pool.find(ProbedKey{i << 18})).front(), static_cast<int>(i));
+		longest = std::max(longest, ProbedKey::probes - before);
+	}
+	//keys sharing their low bits in one probe chain would take keys / 2 probes on average
+	ASSERT_LT(ProbedKey::probes, 8 * keys);
+	ASSERT_LT(longest, 64u);
+}
+
+TEST(index_type, picked_from_capacity) {
+	static_assert(std::is_same_v<CircularBufferFixed<std::uint8_t, 16>::index_type, std::uint8_t>);
+	static_assert(std::is_same_v<CircularBufferFixed<double, 255>::index_type, std::uint8_t>);
+	static_assert(std::is_same_v<CircularBufferFixed<double, 256>::index_type, std::uint16_t>);
+	static_assert(std::is_same_v<CircularBufferFixed<char, 1 << 16>::index_type, std::uint32_t>);
+	static_assert(std::is_same_v<details::index_type_for_t<(std::size_t{1} << 32)>, std::uint64_t>);
+	static_assert(sizeof(CircularBufferFixed<std::uint8_t, 16>) == 16 + 3);
+}
+
+TEST(index_type, selectable) {
+	CircularBufferFixed<int, 3, std::uint64_t> cb (42);
+	static_assert(std::is_same_v<decltype(cb)::index_type, std::uint64_t>);
+	cb.push_front(1);
+	cb.push_front(2);
+	cb.push_front(3);
+	cb.push_front(4);
+	ASSERT_EQ(cb.front(), 4);
+	ASSERT_EQ(cb.back(), 2);
+	ASSERT_EQ(cb[1], 3);
+	ASSERT_EQ(cb.pop_back(), 2);
+	ASSERT_EQ(cb.pop_back(), 3);
+	ASSERT_EQ(cb.pop_back(), 4);
+	ASSERT_TRUE(cb.empty());
+}
+
+TEST(tiny_window, shift_window) {
+	CircularBufferFixed<double, 4> cb;
+	for (double v : {1., 2., 3., 4., 5., 6.}) {
+		cb.push_back(v);
+	}
+	ASSERT_EQ(cb.size(), 4u);
+	ASSERT_EQ(cb.front(), 3.);
+	ASSERT_EQ(cb.back(), 6.);
+	auto const window = cb.window();
+	ASSERT_EQ(window.size(), 4u);
+	ASSERT_EQ(window[0], 3.);
+	ASSERT_EQ(window[3], 6.);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(window.data() - (cb.capacity() - cb.size())) % 32u, 0u);
+	ASSERT_EQ(cb.pop_front(), 3.);
+	ASSERT_EQ(cb.pop_back(), 6.);
+	ASSERT_EQ(cb.window().size(), 2u);
+	ASSERT_EQ(cb.at(0), 4.);
+	ASSERT_EQ(cb.at(1), 5.);
+}
+
+TEST(tiny_window, indices_past_size_stay_in_storage) {
+	CircularBufferFixed<double, 4> tiny;
+	CircularBufferFixed<int, 4> ring;
+	auto const* first = &tiny[0];
+	for (std::size_t idx = 0; idx != 12; ++idx) {
+		ASSERT_GE(&tiny[idx], first);
+		ASSERT_LT(&tiny[idx], first + 4);
+		ASSERT_EQ(tiny[idx], 0.);
+	}
+	for (int v : {1, 2, 3, 4}) {
+		tiny.push_back(v);
+		ring.push_back(v);
+	}
+	tiny.pop_front();
+	ring.pop_front();
+	tiny.pop_front();
+	ring.pop_front();
+	//both specializations agree past the window too
+	for (std::size_t idx = 0; idx != 8; ++idx) {
+		ASSERT_EQ(tiny[idx], ring[idx]);
+		ASSERT_EQ(tiny.at(idx), ring.at(idx));
+	}
+	ASSERT_EQ(tiny.pop_back(), 4.);
+	ASSERT_EQ(tiny.size(), 1u);
+	ASSERT_EQ(tiny.back(), 3.);
+}
+
+template <typename CB>
+void compare_with_deque() {
+	CB cb;
+	std::deque<typename CB::value_type> model;
+	std::mt19937 gen (42);
+	for (int step = 0; step != 10'000; ++step) {
+		auto const value = static_cast<typename CB::value_type>(step);
+		switch (gen() % 4) {
+			case 0:
+				cb.push_back(value);
+				model.push_back(value);
+				if (model.size() > cb.capacity()) {
+					model.pop_front();
+				}
+				break;
+			case 1:
+				cb.push_front(value);
+				model.push_front(value);
+				if (model.size() > cb.capacity()) {
+					model.pop_back();
+				}
+				break;
+			case 2:
+				if (not model.empty()) {
+					ASSERT_EQ(cb.pop_front(), model.front());
+					model.pop_front();
+				}
+				break;
+			default:
+				if (not model.empty()) {
+					ASSERT_EQ(cb.pop_back(), model.back());
+					model.pop_back();
+				}
+				break;
+		}
+		ASSERT_EQ(cb.size(), model.size());
+		if (not model.empty()) {
+			ASSERT_EQ(cb.front(), model.front());
+			ASSERT_EQ(cb.back(), model.back());
+		}
+		for (std::size_t i = 0; i != model.size(); ++i) {
+			ASSERT_EQ(cb[i], model[i]);
+		}
+	}
+}
+
+TEST(tiny_window, same_as_ring) {
+	compare_with_deque<CircularBufferFixed<double, 5>>();
+	compare_with_deque<CircularBufferFixed<float, 16>>();
+	compare_with_deque<CircularBufferFixed<int, 5>>();
+}
+
+TEST(stats, null_policy_is_free) {
+	static_assert(sizeof(CircularBufferFixed<std::uint8_t, 16>) == 16 + 3);
+	static_assert(sizeof(CircularBufferFixed<int, 5, std::uint8_t, stats::Null>) == sizeof(CircularBufferFixed<int, 5>));
+	static_assert(std::is_empty_v<stats::Null>);
+}
+
+template <typename CB>
+void check_counting() {
+	CB cb;
+	cb.pop_front();
+	for (int i = 0; i != 5; ++i) {
+		cb.push_back(i);
+	}
+	cb.push_front(7);
+	cb.pop_back();
+	cb.pop_front();
+	auto s = cb.stats();
+	ASSERT_EQ(s.pushes, 6u);
+	ASSERT_EQ(s.pops, 3u);
+	ASSERT_EQ(s.overwrites, 3u);
+	ASSERT_EQ(s.pops_on_empty, 1u);
+	ASSERT_EQ(s.high_water_mark, 3u);
+	cb.reset_stats();
+	s = cb.stats();
+	ASSERT_EQ(s.pushes, 0u);
+	ASSERT_EQ(s.high_water_mark, 0u);
+}
+
+TEST(stats, counting) {
+	check_counting<CircularBufferFixedWithStats<int, 3, stats::Counting>>();
+	check_counting<CircularBufferFixedWithStats<int, 3, stats::AtomicCounting>>();
+	check_counting<CircularBufferFixedWithStats<double, 3, stats::Counting>>();
+}
+
+TEST(blocking_queue, try_ops_and_timeouts) {
+	BlockingQueue<int, 2> q;
+	ASSERT_FALSE(q.try_pop().has_value());
+	ASSERT_FALSE(q.try_pop_for(std::chrono::milliseconds(5)).has_value());
+	ASSERT_TRUE(q.try_push(1));
+	ASSERT_TRUE(q.try_push_for(2, std::chrono::milliseconds(5)));
+	ASSERT_FALSE(q.try_push(3));
+	ASSERT_FALSE(q.try_push_for(3, std::chrono::milliseconds(5)));
+	ASSERT_EQ(q.size(), 2u);
+	ASSERT_EQ(q.pop(), 1);
+	ASSERT_EQ(q.try_pop_for(std::chrono::milliseconds(5)), 2);
+	ASSERT_TRUE(q.empty());
+}
+
+TEST(blocking_queue, wakes_parked_threads) {
+	BlockingQueue<int, 4, 0> q;
+	std::thread consumer ([&] {
+		ASSERT_EQ(q.pop(), 42);
+		ASSERT_EQ(q.try_pop_until(std::chrono::steady_clock::now() + std::chrono::seconds(10)), 43);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	q.push(42);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	q.push(43);
+	consumer.join();
+}
+
+TEST(blocking_queue, producers_consumers) {
+	constexpr int producers {3}, consumers {3}, per_producer {20'000};
+	BlockingQueue<int, 16> q;
+	std::atomic<long long> sum {0};
+	std::vector<std::thread> threads;
+	for (int p = 0; p != producers; ++p) {
+		threads.emplace_back([&] {
+			for (int i = 1; i <= per_producer; ++i) {
+				q.push(i);
+			}
+		});
+	}
+	for (int c = 0; c != consumers; ++c) {
+		threads.emplace_back([&] {
+			for (int i = 0; i != per_producer; ++i) {
+				sum += q.pop();
+			}
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+	ASSERT_EQ(sum.load(), 1LL * producers * per_producer * (per_producer + 1) / 2);
+	ASSERT_TRUE(q.empty());
+}
+
+Task produce(Channel<int, 4>& channel, int from, int to) {
+	for (int i = from; i != to; ++i) {
+		co_await channel.push(i);
+	}
+}
+
+Task consume(Channel<int, 4>& channel, int count, std::vector<int>& out) {
+	for (int i = 0; i != count; ++i) {
+		out.push_back(co_await channel.pop());
+	}
+}
+
+TEST(channel, consumer_first) {
+	LocalExecutor executor;
+	Channel<int, 4> channel (executor);
+	std::vector<int> out;
+	executor.spawn(consume(channel, 100, out));
+	executor.spawn(produce(channel, 0, 100));
+	executor.run();
+	ASSERT_EQ(out.size(), 100u);
+	for (int i = 0; i != 100; ++i) {
+		ASSERT_EQ(out[i], i);
+	}
+	ASSERT_TRUE(channel.empty());
+}
+
+TEST(channel, producer_first_suspends_on_full) {
+	LocalExecutor executor;
+	Channel<int, 4> channel (executor);
+	std::vector<int> out;
+	executor.spawn(produce(channel, 0, 10));
+	executor.run();
+	ASSERT_EQ(channel.size(), 4u);
+
+	executor.spawn(consume(channel, 10, out));
+	executor.run();
+	ASSERT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+	ASSERT_TRUE(channel.empty());
+}
+
+TEST(channel, many_stages) {
+	LocalExecutor executor;
+	Channel<int, 4> channel (executor);
+	std::vector<int> out;
+	for (int p = 0; p != 10; ++p) {
+		executor.spawn(produce(channel, p * 100, p * 100 + 100));
+	}
+	for (int c = 0; c != 4; ++c) {
+		executor.spawn(consume(channel, 250, out));
+	}
+	executor.run();
+	ASSERT_EQ(out.size(), 1000u);
+	std::sort(out.begin(), out.end());
+	for (int i = 0; i != 1000; ++i) {
+		ASSERT_EQ(out[i], i);
+	}
+}
+
+TEST(spsc_ring, push_peek_consume) {
+	SpscRing<int, 3> ring;
+	ASSERT_EQ(ring.peek(), nullptr);
+	ASSERT_TRUE(ring.try_push(1));
+	ASSERT_TRUE(ring.try_push(2));
+	ASSERT_TRUE(ring.try_push(3));
+	ASSERT_FALSE(ring.try_push(4));
+	ASSERT_EQ(*ring.peek(), 1);
+	ring.pop();
+	ASSERT_TRUE(ring.try_push(4));
+	std::vector<int> out;
+	ASSERT_EQ(ring.consume([&](int v) { out.push_back(v); }), 3u);
+	ASSERT_EQ(out, (std::vector<int>{2, 3, 4}));
+	ASSERT_EQ(ring.size(), 0u);
+}
+
+TEST(mpsc_collector, producers_register_on_first_use) {
+	constexpr int producers {4}, per_producer {50'000};
+	MpscCollector<std::pair<int, int>, 64, producers> collector;
+	std::vector<std::thread> threads;
+	for (int p = 0; p != producers; ++p) {
+		threads.emplace_back([&collector, p] {
+			for (int i = 0; i != per_producer; ++i) {
+				collector.push({p, i});
+			}
+		});
+	}
+	std::vector<int> next (producers, 0);
+	int drained {0};
+	while (drained != producers * per_producer) {
+		drained += static_cast<int>(collector.drain([&](std::pair<int, int> v) {
+			//per producer order is kept
+			ASSERT_EQ(v.second, next[v.first]);
+			++next[v.first];
+		}));
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+	//exited threads have handed their rings back
+	ASSERT_EQ(collector.producers_count(), 0u);
+	std::vector<decltype(collector.register_producer())> held;
+	for (int p = 0; p != producers; ++p) {
+		held.push_back(collector.register_producer());
+	}
+	ASSERT_EQ(collector.producers_count(), static_cast<std::size_t>(producers));
+	ASSERT_THROW(collector.register_producer(), std::length_error);
+	held.pop_back();
+	ASSERT_NO_THROW(collector.register_producer());
+}
+
+namespace {
+	struct CopyCounted {
+		static inline std::atomic<int> copies {0};
+		int value {0};
+
+		CopyCounted () = default;
+		CopyCounted (int v) : value {v} {}
+		CopyCounted (CopyCounted const& other) : value {other.value} { ++copies; }
+		CopyCounted (CopyCounted&&) noexcept = default;
+		CopyCounted& operator=(CopyCounted const& other) { value = other.value; ++copies; return *this; }
+		CopyCounted& operator=(CopyCounted&&) noexcept = default;
+	};
+
+	template <DrainOrder Order>
+	void push_never_copies() {
+		MpscCollector<CopyCounted, 4, 1, Order> collector;
+		CopyCounted::copies = 0;
+		auto producer = collector.register_producer();
+		for (int i = 0; i != 4; ++i) {
+			producer.push(CopyCounted{i});
+		}
+		std::thread late ([&] {
+			//retries while the ring is full
+			producer.push(CopyCounted{4});
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		ASSERT_EQ(CopyCounted::copies.load(), 0);
+		int drained {0};
+		while (drained != 5) {
+			drained += static_cast<int>(collector.drain([](CopyCounted const&) {}));
+		}
+		late.join();
+	}
+}
+
+TEST(mpsc_collector, push_moves_the_value) {
+	push_never_copies<DrainOrder::RoundRobin>();
+	push_never_copies<DrainOrder::Sequenced>();
+	ASSERT_EQ(CopyCounted::copies.load(), 0);
+}
+
+TEST(mpsc_collector, short_lived_threads_reuse_rings) {
+	MpscCollector<int, 64, 2> collector;
+	int drained {0};
+	for (int round = 0; round != 20; ++round) {
+		std::thread first ([&] { collector.push(1); });
+		std::thread second ([&] { collector.push(2); });
+		first.join();
+		second.join();
+		drained += static_cast<int>(collector.drain([](int) {}));
+	}
+	ASSERT_EQ(drained, 40);
+	ASSERT_EQ(collector.producers_count(), 0u);
+}
+
+TEST(mpsc_collector, dead_collectors_are_forgotten) {
+	std::thread worker ([] {
+		for (int round = 0; round != 100; ++round) {
+			auto collector = std::make_unique<MpscCollector<int, 8, 1>>();
+			//would run out of its single ring if a stale registration were matched
+			ASSERT_TRUE(collector->try_push(round));
+			ASSERT_EQ(collector->producers_count(), 1u);
+			int value {-1};
+			ASSERT_EQ(collector->drain([&](int v) { value = v; }), 1u);
+			ASSERT_EQ(value, round);
+		}
+	});
+	worker.join();
+}
+
+TEST(mpsc_collector, sequenced_drain) {
+	MpscCollector<int, 16, 2, DrainOrder::Sequenced> collector;
+	auto first = collector.register_producer();
+	auto second = collector.register_producer();
+	for (int i = 0; i != 10; ++i) {
+		ASSERT_TRUE((i % 3 == 0 ? first : second).try_push(i));
+	}
+	std::vector<int> out;
+	ASSERT_EQ(collector.drain([&](int v) { out.push_back(v); }), 10u);
+	ASSERT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(seqlock_window, snapshot_newest) {
+	SeqlockWindow<int, 4> window;
+	std::array<int, 4> out {};
+	ASSERT_EQ(window.snapshot_into(out), 0u);
+	for (int i = 0; i != 6; ++i) {
+		window.push_back(i);
+	}
+	ASSERT_EQ(window.snapshot_into(out), 4u);
+	ASSERT_EQ(out, (std::array<int, 4>{2, 3, 4, 5}));
+	std::array<int, 3> shorter {};
+	ASSERT_EQ(window.try_snapshot(shorter), std::optional<std::size_t>(3u));
+	ASSERT_EQ(shorter, (std::array<int, 3>{3, 4, 5}));
+	window.pop_front();
+	ASSERT_EQ(window.size(), 3u);
+	ASSERT_EQ(window.snapshot_into(out), 3u);
+	ASSERT_EQ(out[0], 3);
+	ASSERT_EQ(out[2], 5);
+	window.clear();
+	ASSERT_EQ(window.snapshot_into(out), 0u);
+}
+
+TEST(seqlock_window, elements_not_word_sized) {
+	using Triple = std::array<std::uint16_t, 3>;
+	SeqlockWindow<Triple, 3> window;
+	for (std::uint16_t i = 0; i != 5; ++i) {
+		window.push_back(Triple{i, std::uint16_t(i + 1), std::uint16_t(i + 2)});
+	}
+	std::array<Triple, 3> out {};
+	ASSERT_EQ(window.snapshot_into(out), 3u);
+	ASSERT_EQ(out[0], (Triple{2, 3, 4}));
+	ASSERT_EQ(out[2], (Triple{4, 5, 6}));
+}
+
+TEST(seqlock_window, readers_never_see_torn_window) {
+	constexpr std::size_t n {64};
+	constexpr std::uint64_t pushes {1'000'000};
+	SeqlockWindow<std::uint64_t, n> window;
+	std::atomic<bool> done {false};
+	std::vector<std::thread> readers;
+	for (int r = 0; r != 2; ++r) {
+		readers.emplace_back([&] {
+			std::array<std::uint64_t, n> out;
+			while (not done.load(std::memory_order_relaxed)) {
+				std::size_t const count = window.snapshot_into(out);
+				for (std::size_t i = 1; i < count; ++i) {
+					ASSERT_EQ(out[i], out[i - 1] + 1);
+				}
+			}
+		});
+	}
+	for (std::uint64_t i = 0; i != pushes; ++i) {
+		window.push_back(i);
+	}
+	done.store(true, std::memory_order_relaxed);
+	for (auto& t : readers) {
+		t.join();
+	}
+	std::array<std::uint64_t, n> out;
+	ASSERT_EQ(window.snapshot_into(out), n);
+	ASSERT_EQ(out.back(), pushes - 1);
+}
+
+TEST(io, segments_and_commit) {
+	CircularBufferFixed<int, 5> cb;
+	for (int i = 0; i != 7; ++i) {
+		cb.push_back(i);
+	}
+	ASSERT_EQ(cb.array_one().size(), 3u);
+	ASSERT_EQ(cb.array_one()[0], 2);
+	ASSERT_EQ(cb.array_two().size(), 2u);
+	ASSERT_EQ(cb.array_two()[1], 6);
+	ASSERT_TRUE(cb.free_array_one().empty());
+	cb.pop_front();
+	cb.pop_front();
+	ASSERT_EQ(cb.free_array_one().size(), 2u);
+	ASSERT_TRUE(cb.free_array_two().empty());
+	cb.free_array_one()[0] = 7;
+	cb.free_array_one()[1] = 8;
+	cb.commit_back(2);
+	ASSERT_EQ(cb.size(), 5u);
+	ASSERT_EQ(cb.front(), 4);
+	ASSERT_EQ(cb.back(), 8);
+	cb.push_back(9);
+	ASSERT_EQ(cb[0], 5);
+	ASSERT_EQ(cb[4], 9);
+
+	CircularBufferFixed<int, 5> wrapping_free;
+	for (int i = 0; i != 3; ++i) {
+		wrapping_free.push_back(i);
+	}
+	wrapping_free.pop_front();
+	wrapping_free.pop_front();
+	ASSERT_EQ(wrapping_free.free_array_one().size(), 2u);
+	ASSERT_EQ(wrapping_free.free_array_two().size(), 2u);
+	wrapping_free.free_array_one()[0] = 3;
+	wrapping_free.free_array_one()[1] = 4;
+	wrapping_free.free_array_two()[0] = 5;
+	wrapping_free.commit_back(3);
+	ASSERT_EQ(wrapping_free.size(), 4u);
+	ASSERT_EQ(wrapping_free.front(), 2);
+	ASSERT_EQ(wrapping_free.back(), 5);
+	ASSERT_EQ(wrapping_free.array_two().size(), 1u);
+}
+
+TEST(io, pipe_round_trip) {
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	CircularBufferFixed<int, 5> wrapped;
+	for (int i = 0; i != 8; ++i) {
+		wrapped.push_back(i);
+	}
+	ASSERT_EQ(write_to(wrapped, fds[1]), 5 * sizeof(int));
+	ASSERT_EQ(wrapped.size(), 5u);
+
+	CircularBufferFixed<int, 4> target;
+	target.push_back(-2);
+	target.push_back(-1);
+	target.pop_front();
+	//only the free space is filled, the rest stays in the pipe
+	ASSERT_EQ(read_from(target, fds[0]), 3u);
+	ASSERT_EQ(target.size(), 4u);
+	ASSERT_EQ(target[0], -1);
+	ASSERT_EQ(target[1], 3);
+	ASSERT_EQ(target[3], 5);
+	ASSERT_EQ(read_from(target, fds[0]), 0u);
+
+	CircularBufferFixed<int, 8> rest;
+	ASSERT_EQ(read_from(rest, fds[0]), 2u);
+	ASSERT_EQ(rest[0], 6);
+	ASSERT_EQ(rest[1], 7);
+
+	close(fds[1]);
+	ASSERT_EQ(read_from(rest, fds[0]), 0u);
+	close(fds[0]);
+}
+
+TEST(io, tiny_window_round_trip) {
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	CircularBufferFixed<double, 4> source;
+	for (int i = 0; i != 6; ++i) {
+		source.push_back(i);
+	}
+	ASSERT_EQ(write_to(source, fds[1]), 4 * sizeof(double));
+	CircularBufferFixed<double, 4> target;
+	target.push_back(-1.0);
+	ASSERT_EQ(read_from(target, fds[0]), 3u);
+	ASSERT_EQ(target.front(), -1.0);
+	ASSERT_EQ(target[1], 2.0);
+	ASSERT_EQ(target.back(), 4.0);
+	ASSERT_EQ(target.size(), 4u);
+	target.pop_front();
+	ASSERT_EQ(read_from(target, fds[0]), 1u);
+	ASSERT_EQ(target.back(), 5.0);
+	close(fds[1]);
+	close(fds[0]);
+}
+
+TEST(io, element_split_across_reads) {
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	std::uint64_t const value {0x0102030405060708ull};
+	auto const* bytes = reinterpret_cast<char const*>(&value);
+	std::thread writer ([&] {
+		ASSERT_EQ(write(fds[1], bytes, 3), 3);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_EQ(write(fds[1], bytes + 3, 5), 5);
+		close(fds[1]);
+	});
+	CircularBufferFixed<std::uint64_t, 4> target;
+	ASSERT_EQ(read_from(target, fds[0]), 1u);
+	ASSERT_EQ(target.back(), value);
+	writer.join();
+	close(fds[0]);
+}
+
+TEST(io, non_blocking_keeps_whole_elements) {
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	ASSERT_EQ(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+	CircularBufferFixed<std::uint64_t, 64> target;
+	ASSERT_EQ(read_from(target, fds[0]), 0u);
+	std::array<std::uint64_t, 2> const values {7, 8};
+	ASSERT_EQ(write(fds[1], values.data(), 12), 12);
+	ASSERT_THROW(read_from(target, fds[0]), std::system_error);
+	ASSERT_EQ(target.size(), 1u);
+	ASSERT_EQ(target.back(), 7u);
+	close(fds[1]);
+	close(fds[0]);
+}
+
+TEST(parallel, algorithms_keep_logical_order) {
+	constexpr std::size_t n {std::size_t{1} << 17};
+	auto cb = std::make_unique<CircularBufferFixed<std::int64_t, n>>();
+	std::mt19937_64 gen (42);
+	std::vector<std::int64_t> pushed;
+	for (std::size_t i = 0; i != n + n / 3; ++i) {
+		pushed.push_back(static_cast<std::int64_t>(gen() % 1'000'000));
+		cb->push_back(pushed.back());
+	}
+	std::vector<std::int64_t> const expected (pushed.end() - n, pushed.end());
+	ASSERT_FALSE(cb->array_two().empty());
+
+	std::vector<std::int64_t> copied (n);
+	ASSERT_EQ(parallel::copy_to(*cb, copied.begin(), 4), n);
+	ASSERT_EQ(copied, expected);
+
+	//combines adjacent index ranges, fails on any reordering
+	using Range = std::pair<std::int64_t, std::int64_t>;
+	auto positions = std::make_unique<CircularBufferFixed<std::int64_t, n>>();
+	for (std::size_t i = 0; i != n + 5; ++i) {
+		positions->push_back(static_cast<std::int64_t>(i));
+	}
+	Range const joined = parallel::transform_reduce(*positions, Range{4, 4},
+			[](Range a, Range b) {
+				return a.second + 1 == b.first ? Range{a.first, b.second} : Range{-1, -1};
+			},
+			[](std::int64_t i) {
+				return Range{i, i};
+			}, 4);
+	ASSERT_EQ(joined, Range(4, static_cast<std::int64_t>(n + 4)));
+
+	std::int64_t const sum = parallel::transform_reduce(*cb, std::int64_t{0}, std::plus<>{}, [](std::int64_t v) { return v; }, 4);
+	ASSERT_EQ(sum, std::accumulate(expected.begin(), expected.end(), std::int64_t{0}));
+
+	std::vector<std::int64_t> sorted (n);
+	ASSERT_EQ(parallel::sort_copy(*cb, sorted.begin(), std::less<>{}, 3), n);
+	auto reference = expected;
+	std::sort(reference.begin(), reference.end());
+	ASSERT_EQ(sorted, reference);
+
+	parallel::for_each(*cb, [](std::int64_t& v) { v *= 2; }, 4);
+	for (std::size_t i = 0; i < n; i += 997) {
+		ASSERT_EQ((*cb)[i], expected[i] * 2);
+	}
+}
+
+TEST(parallel, small_and_tiny_windows) {
+	CircularBufferFixed<double, 4> tiny;
+	for (int i = 0; i != 6; ++i) {
+		tiny.push_back(i);
+	}
+	std::array<double, 4> out {};
+	ASSERT_EQ(parallel::sort_copy(tiny, out.begin(), std::greater<>{}), 4u);
+	ASSERT_EQ(out, (std::array<double, 4>{5.0, 4.0, 3.0, 2.0}));
+	CircularBufferFixed<int, 8> empty;
+	ASSERT_EQ(parallel::transform_reduce(empty, 7, std::plus<>{}, [](int v) { return v; }), 7);
+	ASSERT_EQ(parallel::copy_to(empty, out.begin()), 0u);
+}
+
+TEST(rolling_covariance, matches_direct_computation) {
+	constexpr std::size_t n {16}, k {5};
+	RollingCovariance<double, n, k> rolling;
+	std::deque<std::array<double, k>> rows;
+	std::mt19937 gen (7);
+	std::normal_distribution<double> noise (100.0, 3.0);
+	for (int t = 0; t != 100; ++t) {
+		std::array<double, k> row;
+		for (std::size_t i = 0; i != k; ++i) {
+			row[i] = noise(gen);
+		}
+		//series 4 follows series 0 exactly
+		row[4] = 2 * row[0] + 1;
+		rolling.push(row);
+		rows.push_back(row);
+		if (rows.size() > n) {
+			rows.pop_front();
+		}
+		if (rows.size() < 2u) {
+			ASSERT_TRUE(std::isnan(rolling.covariance(0, 1)));
+			continue;
+		}
+		for (std::size_t i = 0; i != k; ++i) {
+			for (std::size_t j = 0; j != k; ++j) {
+				double mean_i {0}, mean_j {0};
+				for (auto const& r : rows) {
+					mean_i += r[i];
+					mean_j += r[j];
+				}
+				mean_i /= static_cast<double>(rows.size());
+				mean_j /= static_cast<double>(rows.size());
+				double expected {0};
+				for (auto const& r : rows) {
+					expected += (r[i] - mean_i) * (r[j] - mean_j);
+				}
+				expected /= static_cast<double>(rows.size() - 1);
+				ASSERT_NEAR(rolling.covariance(i, j), expected, 1e-6);
+			}
+		}
+		ASSERT_NEAR(rolling.correlation(0, 4), 1.0, 1e-9);
+	}
+	std::array<double, k * k> corr;
+	rolling.correlation(corr);
+	ASSERT_EQ(corr[0], 1.0);
+	ASSERT_NEAR(corr[4], 1.0, 1e-9);
+	ASSERT_LT(std::abs(corr[1]), 1.0);
+	ASSERT_EQ(rolling.size(), n);
+}
+
+TEST(fast_copy, copies_only_the_window) {
+	//above windowed_copy_min_bytes, so the copies go through memcpy of the window
+	constexpr std::size_t n {80};
+	using Buffer = CircularBufferFixed<int, n>;
+	static_assert(not std::is_trivially_copyable_v<Buffer>);
+	Buffer sparse;
+	sparse.push_back(1);
+	sparse.push_back(2);
+	sparse.pop_front();
+	sparse.push_back(3);
+	Buffer copy (sparse);
+	ASSERT_EQ(copy.size(), 2u);
+	ASSERT_EQ(copy[0], 2);
+	ASSERT_EQ(copy[1], 3);
+
+	Buffer wrapped;
+	for (int i = 0; i != static_cast<int>(n) + 7; ++i) {
+		wrapped.push_back(i);
+	}
+	ASSERT_FALSE(wrapped.array_two().empty());
+	Buffer moved (std::move(wrapped));
+	Buffer assigned;
+	assigned = moved;
+	moved.push_back(static_cast<int>(n) + 7);
+	for (std::size_t i = 0; i != n; ++i) {
+		ASSERT_EQ(assigned[i], static_cast<int>(i) + 7);
+		ASSERT_EQ(moved[i], static_cast<int>(i) + 8);
+	}
+	Buffer short_window;
+	short_window.push_back(3);
+	assigned = std::move(short_window);
+	ASSERT_EQ(assigned.size(), 1u);
+	ASSERT_EQ(assigned.back(), 3);
+	//the copy is fully usable: linearize and swap read its live slots only
+	assigned.push_back(4);
+	ASSERT_EQ(assigned.linearize()[1], 4);
+	swap(assigned, moved);
+	ASSERT_EQ(moved.size(), 2u);
+	ASSERT_EQ(assigned.back(), static_cast<int>(n) + 7);
+
+	//non trivially copyable elements keep the member-wise copy
+	CircularBufferFixed<std::string, 3> strings;
+	strings.push_back("a");
+	strings.push_back("b");
+	auto strings_copy = strings;
+	ASSERT_EQ(strings_copy[1], "b");
+}
+
+TEST(fast_copy, small_buffers_stay_trivially_copyable) {
+	static_assert(std::is_trivially_copyable_v<CircularBufferFixed<int, 8>>);
+	static_assert(std::is_trivially_copyable_v<CircularBufferFixed<double, 4>>);
+	static_assert(std::is_trivially_copyable_v<CircularBufferFixed<std::uint64_t, 32>>);
+	static_assert(not std::is_trivially_copyable_v<CircularBufferFixed<int, 1024>>);
+	static_assert(not std::is_trivially_copyable_v<CircularBufferFixed<std::string, 2>>);
+	CircularBufferFixed<int, 8> small;
+	small.push_back(1);
+	auto copy = small;
+	ASSERT_EQ(copy.back(), 1);
+}
+
+TEST(fast_copy, linearize_and_swap_read_only_live_slots) {
+	//strings outside the windows are moved-from husks, the window never reads them
+	CircularBufferFixed<std::string, 6> a, b;
+	for (int i = 0; i != 9; ++i) {
+		a.push_back(std::to_string(i));
+	}
+	a.pop_front();
+	a.pop_front();
+	b.push_back("x");
+	b.push_back("y");
+	b.pop_front();
+	swap(a, b);
+	ASSERT_EQ(a.size(), 1u);
+	ASSERT_EQ(a.front(), "y");
+	ASSERT_EQ(b.size(), 4u);
+	for (std::size_t i = 0; i != b.size(); ++i) {
+		ASSERT_EQ(b[i], std::to_string(i + 5));
+	}
+	auto window = b.linearize();
+	ASSERT_EQ(window.size(), 4u);
+	for (std::size_t i = 0; i != window.size(); ++i) {
+		ASSERT_EQ(window[i], std::to_string(i + 5));
+	}
+	CircularBufferFixed<std::string, 4> full;
+	for (int i = 0; i != 6; ++i) {
+		full.push_back(std::to_string(i));
+	}
+	auto full_window = full.linearize();
+	ASSERT_EQ(full_window[0], "2");
+	ASSERT_EQ(full_window[3], "5");
+}
+
+TEST(fast_copy, linearize) {
+	CircularBufferFixed<int, 6> shifted;
+	for (int i = 0; i != 4; ++i) {
+		shifted.push_back(i);
+	}
+	shifted.pop_front();
+	shifted.pop_front();
+	auto window = shifted.linearize();
+	ASSERT_EQ(window.size(), 2u);
+	ASSERT_EQ(window.data(), &shifted[0]);
+	ASSERT_EQ(window[0], 2);
+	ASSERT_EQ(window[1], 3);
+
+	CircularBufferFixed<int, 6> wrapped;
+	for (int i = 0; i != 9; ++i) {
+		wrapped.push_back(i);
+	}
+	wrapped.pop_front();
+	window = wrapped.linearize();
+	ASSERT_EQ(window.size(), 5u);
+	for (std::size_t i = 0; i != window.size(); ++i) {
+		ASSERT_EQ(window[i], static_cast<int>(i) + 4);
+	}
+	ASSERT_TRUE(wrapped.array_two().empty());
+	wrapped.push_back(9);
+	wrapped.push_back(10);
+	ASSERT_EQ(wrapped.front(), 5);
+	ASSERT_EQ(wrapped.back(), 10);
+
+	CircularBufferFixed<double, 4> tiny;
+	tiny.push_back(1.0);
+	tiny.push_back(2.0);
+	ASSERT_EQ(tiny.linearize().size(), 2u);
+	ASSERT_EQ(tiny.linearize()[1], 2.0);
+}
+
+TEST(fast_copy, swap) {
+	CircularBufferFixed<int, 6> a, b;
+	for (int i = 0; i != 8; ++i) {
+		a.push_back(i);
+	}
+	b.push_back(100);
+	b.push_back(101);
+	b.pop_front();
+	swap(a, b);
+	ASSERT_EQ(a.size(), 1u);
+	ASSERT_EQ(a.front(), 101);
+	ASSERT_EQ(b.size(), 6u);
+	for (std::size_t i = 0; i != 6; ++i) {
+		ASSERT_EQ(b[i], static_cast<int>(i) + 2);
+	}
+	a.swap(b);
+	ASSERT_EQ(a.size(), 6u);
+	ASSERT_EQ(a.back(), 7);
+	ASSERT_EQ(b.front(), 101);
+
+	CircularBufferFixed<double, 4> tiny_a, tiny_b;
+	tiny_a.push_back(1.0);
+	swap(tiny_a, tiny_b);
+	ASSERT_TRUE(tiny_a.empty());
+	ASSERT_EQ(tiny_b.back(), 1.0);
+}
+
+namespace constexpr_checks {
+
+	constexpr bool ring_wraps() {
+		CircularBufferFixed<int, 4> cb;
+		for (int i = 0; i != 6; ++i) {
+			cb.push_back(i);
+		}
+		bool ok = cb.size() == 4u && cb.front() == 2 && cb.back() == 5 && cb[1] == 3 && cb.at(3) == 5;
+		cb.push_front(1);
+		ok = ok && cb.front() == 1 && cb.back() == 4;
+		ok = ok && cb.pop_back() == 4 && cb.pop_front() == 1 && cb.size() == 2u;
+		ok = ok && cb.array_one().size() + cb.array_two().size() == 2u;
+		return ok;
+	}
+
+	constexpr bool copy_swap_linearize() {
+		CircularBufferFixed<int, 5> a;
+		for (int i = 0; i != 7; ++i) {
+			a.push_back(i);
+		}
+		CircularBufferFixed<int, 5> b (a);
+		CircularBufferFixed<int, 5> c;
+		c.push_back(42);
+		swap(b, c);
+		auto const window = c.linearize();
+		return b.size() == 1u && b.front() == 42
+			   && window.size() == 5u && window[0] == 2 && window[4] == 6;
+	}
+
+	constexpr bool tiny_window_shifts() {
+		CircularBufferFixed<double, 4> tiny;
+		for (int i = 0; i != 6; ++i) {
+			tiny.push_back(i);
+		}
+		bool ok = tiny.front() == 2.0 && tiny.back() == 5.0 && tiny.window().size() == 4u;
+		ok = ok && tiny.pop_back() == 5.0 && tiny.pop_front() == 2.0 && tiny[0] == 3.0;
+		return ok;
+	}
+
+	constexpr bool stats_count() {
+		CircularBufferFixedWithStats<int, 2, stats::Counting> cb;
+		cb.push_back(1);
+		cb.push_back(2);
+		cb.push_back(3);
+		cb.pop_front();
+		return cb.stats().pushes == 3u && cb.stats().overwrites == 1u && cb.stats().high_water_mark == 2u;
+	}
+
+	constexpr auto make_kernel() {
+		CircularBufferFixed<int, 3> kernel;
+		kernel.push_back(1);
+		kernel.push_back(2);
+		kernel.push_back(1);
+		return kernel;
+	}
+
+	static_assert(ring_wraps());
+	static_assert(copy_swap_linearize());
+	static_assert(tiny_window_shifts());
+	static_assert(stats_count());
+
+	constexpr auto kernel = make_kernel();
+	static_assert(kernel[0] + kernel[1] + kernel[2] == 4);
+	static_assert(CircularBufferFixed<double, 8>(1.5).back() == 1.5);
+
+	constinit CircularBufferFixed<int, 16> preseeded (7);
+
+}//!namespace constexpr_checks
+
+TEST(constexpr_buffer, constant_initialized) {
+	ASSERT_EQ(constexpr_checks::preseeded.size(), 16u);
+	ASSERT_EQ(constexpr_checks::preseeded.front(), 7);
+	constexpr_checks::preseeded.push_back(8);
+	ASSERT_EQ(constexpr_checks::preseeded.back(), 8);
+	ASSERT_EQ(constexpr_checks::kernel[1], 2);
+}
+
+TEST(rolling_covariance, float_large_mean_small_spread) {
+	constexpr std::size_t n {256};
+	RollingCovariance<float, n, 2> rolling;
+	std::deque<std::array<double, 2>> rows;
+	std::mt19937 gen (11);
+	std::normal_distribution<double> noise (0.0, 0.01);
+	for (int t = 0; t != 20'000; ++t) {
+		double const common = noise(gen);
+		std::array<float, 2> const row {
+			static_cast<float>(1000.0 + common),
+			static_cast<float>(1000.0 + 0.5 * common + noise(gen))
+		};
+		rolling.push(row);
+		rows.push_back({row[0], row[1]});
+		if (rows.size() > n) {
+			rows.pop_front();
+		}
+	}
+	std::array<double, 2> mean {0, 0};
+	for (auto const& r : rows) {
+		mean[0] += r[0];
+		mean[1] += r[1];
+	}
+	mean[0] /= n;
+	mean[1] /= n;
+	std::array<double, 3> expected {0, 0, 0};
+	for (auto const& r : rows) {
+		expected[0] += (r[0] - mean[0]) * (r[0] - mean[0]);
+		expected[1] += (r[0] - mean[0]) * (r[1] - mean[1]);
+		expected[2] += (r[1] - mean[1]) * (r[1] - mean[1]);
+	}
+	for (auto& e : expected) {
+		e /= n - 1;
+	}
+	ASSERT_GT(rolling.covariance(0, 0), 0.f);
+	ASSERT_NEAR(rolling.covariance(0, 0), expected[0], expected[0] * 0.01);
+	ASSERT_NEAR(rolling.covariance(0, 1), expected[1], expected[0] * 0.01);
+	ASSERT_NEAR(rolling.covariance(1, 1), expected[2], expected[2] * 0.01);
+	double const corr = expected[1] / std::sqrt(expected[0] * expected[2]);
+	ASSERT_FALSE(std::isnan(rolling.correlation(0, 1)));
+	ASSERT_NEAR(rolling.correlation(0, 1), corr, 0.01);
+}
+
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
 	testing::GTEST_FLAG(color) = "yes";